@@ -21,9 +21,14 @@ namespace ROS2
     //! ros2 static and dynamic transforms (/tf_static, /tf). It also facilitates namespace handling.
     //! An entity can only have a single ROS2Frame on each level. Many ROS2 Components require this component.
     //! @note A robot should have this component on every level of entity hierarchy (for each joint, fixed or dynamic)
+    //! While the component is active, its parent frame, frame id and namespace are resolved once and cached. Caches of all
+    //! frames are invalidated when a frame is activated, deactivated or renamed, or when its entity or an entity between it
+    //! and its parent frame changes parent.
+    //! Frame queries are to be made from the main thread.
     class ROS2FrameComponent
         : public AZ::Component
         , public AZ::TickBus::Handler
+        , public AZ::TransformNotificationBus::MultiHandler
     {
     public:
         AZ_COMPONENT(ROS2FrameComponent, "{EE743472-3E25-41EA-961B-14096AC1D66F}");
@@ -41,14 +46,14 @@ namespace ROS2
 
         //! Get a frame id, which is needed for any ROS2 message with a Header
         //! @return Frame id which includes the namespace, ready to send in a ROS2 message
-        AZStd::string GetFrameID() const;
+        const AZStd::string& GetFrameID() const;
 
         //! Set a above-mentioned frame id
         void SetFrameID(const AZStd::string& frameId);
 
         //! Get a namespace, which should be used for any publisher or subscriber in the same entity.
         //! @return A complete namespace (including parent namespaces)
-        AZStd::string GetNamespace() const;
+        const AZStd::string& GetNamespace() const;
 
         //! Get AZ Transform for this frame.
         //! @return If parent ROS2Frame is found, return its Transform.
@@ -57,11 +62,38 @@ namespace ROS2
 
         //! Global frame name in ros2 ecosystem.
         //! @return The name of the global frame with namespace attached. It is typically "odom", "map", "world".
-        AZStd::string GetGlobalFrameName() const; // TODO - allow to configure global frame in a specialized component
+        const AZStd::string& GetGlobalFrameName() const; // TODO - allow to configure global frame in a specialized component
 
     private:
+        //! Frame hierarchy resolved from ancestors.
+        struct FrameHierarchy
+        {
+            AZ::u64 m_version = 0; //!< Version of all frame hierarchies it was resolved in, zero if it is not cached.
+            const ROS2FrameComponent* m_parentFrame = nullptr;
+            AZ::TransformInterface* m_transformInterface = nullptr;
+            AZStd::string m_namespace;
+            AZStd::string m_frameId;
+            AZStd::string m_parentFrameId;
+            AZStd::string m_globalFrameName;
+        };
+
+        //! Get the frame hierarchy, cached while the component is active and resolved on each call otherwise.
+        const FrameHierarchy& GetFrameHierarchy() const;
+
+        //! Invalidate cached hierarchies of all frames, since namespaces and frame ids depend on ancestors.
+        static void InvalidateFrameHierarchies();
+
         void OnTick(float deltaTime, AZ::ScriptTimePoint time) override;
 
+        ////////////////////////////////////////////////////////////////////////
+        // AZ::TransformNotificationBus::MultiHandler interface implementation
+        void OnParentChanged(AZ::EntityId oldParent, AZ::EntityId newParent) override;
+        ////////////////////////////////////////////////////////////////////////
+
+        //! Connect to transform notifications of the entity and of its ancestors up to the parent frame, which the frame
+        //! hierarchy depends on. Changes above the parent frame are handled by the parent frame, invalidating all caches.
+        void ConnectHierarchyNotifications();
+
         bool IsTopLevel() const; //!< True if this entity does not have a parent entity with ROS2.
 
         //! Whether transformation to parent frame can change during the simulation, or is fixed.
@@ -71,7 +103,7 @@ namespace ROS2
 
         //! If parent entity does not exist or does not have a ROS2FrameComponent, return ROS2 default global frame.
         //! @see GetGlobalFrameName().
-        AZStd::string GetParentFrameID() const;
+        const AZStd::string& GetParentFrameID() const;
 
         // TODO - Editor component: validation of fields, constraints between values and so on
         NamespaceConfiguration m_namespaceConfiguration;
@@ -79,5 +111,8 @@ namespace ROS2
 
         bool m_publishTransform = true;
         AZStd::unique_ptr<ROS2Transform> m_ros2Transform;
+
+        bool m_isActive = false;
+        mutable FrameHierarchy m_frameHierarchy;
     };
 } // namespace ROS2
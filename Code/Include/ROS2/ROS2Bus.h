@@ -9,6 +9,7 @@
 
 #include <AzCore/EBus/EBus.h>
 #include <AzCore/Interface/Interface.h>
+#include <AzCore/std/functional.h>
 #include <builtin_interfaces/msg/time.hpp>
 #include <geometry_msgs/msg/transform_stamped.hpp>
 #include <rclcpp/node.hpp>
@@ -32,6 +33,22 @@ namespace ROS2
         //! @note Alternatively, you can use your own node along with an executor.
         virtual std::shared_ptr<rclcpp::Node> GetNode() const = 0;
 
+        //! Get a node for publishers and subscriptions of a namespace, such as those of one robot. It is created on first use
+        //! and spun by the Gem executor, like the central node.
+        //! Each node has its own default callback group, so with the multi-threaded executor callbacks of different robots
+        //! run in parallel instead of waiting for each other, and no single node carries the traffic of all robots.
+        //! Further callback groups can be created with rclcpp::Node::create_callback_group.
+        //! Nodes are in the root namespace and named after the namespace they serve, with a numeric suffix if that name is
+        //! taken by the node of another namespace, so names of topics are resolved as with GetNode().
+        //! The node is removed from the executor and destroyed once all pointers returned for its namespace are released,
+        //! so hold the pointer while using the node, such as while a component is active.
+        //! @code
+        //! m_node = ROS2Interface::Get()->GetNamespaceNode(GetNamespace());
+        //! @endcode
+        //! @param ros2Namespace - namespace served by the node; the central node is returned for the empty namespace
+        //! @note Call from the main thread.
+        virtual std::shared_ptr<rclcpp::Node> GetNamespaceNode(const AZStd::string& ros2Namespace) = 0;
+
         //! Acquire current time as ROS2 timestamp.
         //! Timestamps provide temporal context for messages such as sensor data.
         //! @code
@@ -47,9 +64,21 @@ namespace ROS2
         //! message</a>.
         //! @param isDynamic controls whether a static or dynamic transform is sent. Static transforms are published
         //! only once and are to be used when the spatial relationship between two frames does not change.
+        //! @note Transforms sent during a tick are published together at its end, dynamic ones in a single /tf message,
+        //! possibly at a lower rate, see TransformAggregator. Send them from the main thread.
         //! @note Transforms are already published by each ROS2FrameComponent.
         //! Use this function directly only when default behavior of ROS2FrameComponent is not sufficient.
         virtual void BroadcastTransform(const geometry_msgs::msg::TransformStamped& t, bool isDynamic) const = 0;
+
+        //! Run a function on the main thread, such as to apply a received message to the simulation.
+        //! ROS 2 callbacks can be executed on executor threads, depending on the executor mode of the Gem. Functions queued
+        //! from there run at the beginning of the next ROS2 system tick, before components tick, in the order of queueing.
+        //! When callbacks are executed on the main thread, the function is called immediately.
+        //! @code
+        //! ROS2Interface::Get()->QueueOnMainThread([entityId, velocity]() { ApplyVelocity(entityId, velocity); });
+        //! @endcode
+        //! @param function - function to run; it must not capture objects which can be destroyed before it runs
+        virtual void QueueOnMainThread(AZStd::function<void()> function) = 0;
     };
 
     class ROS2BusTraits : public AZ::EBusTraits
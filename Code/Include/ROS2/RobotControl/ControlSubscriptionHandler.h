@@ -11,6 +11,8 @@
 #include "ROS2/Frame/ROS2FrameComponent.h"
 #include "ROS2/ROS2Bus.h"
 #include "ROS2/Utilities/ROS2Names.h"
+#include <AzCore/std/smart_ptr/make_shared.h>
+#include <AzCore/std/smart_ptr/weak_ptr.h>
 #include <rclcpp/rclcpp.hpp>
 
 namespace ROS2
@@ -29,6 +31,7 @@ namespace ROS2
     };
 
     //! The generic class for handling subscriptions to ROS2 control messages of different types.
+    //! Messages are sent to the bus on the main thread, at the beginning of the tick which follows their reception.
     //! @see ControlConfiguration::Steering.
     template<typename T>
     class ControlSubscriptionHandler : public IControlSubscriptionHandler
@@ -38,18 +41,26 @@ namespace ROS2
         {
             m_active = true;
             m_entityId = entity->GetId();
+            m_activationToken = AZStd::make_shared<bool>(true);
             if (!m_controlSubscription)
             {
                 auto ros2Frame = entity->FindComponent<ROS2FrameComponent>();
                 AZStd::string namespacedTopic = ROS2Names::GetNamespacedName(ros2Frame->GetNamespace(), subscriberConfiguration.m_topic);
 
-                auto ros2Node = ROS2Interface::Get()->GetNode();
-                m_controlSubscription = ros2Node->create_subscription<T>(
+                m_ros2Node = ROS2Interface::Get()->GetNamespaceNode(ros2Frame->GetNamespace());
+                m_controlSubscription = m_ros2Node->create_subscription<T>(
                     namespacedTopic.data(),
                     subscriberConfiguration.GetQoS(),
-                    [this](const T& message)
-                    {
-                        OnControlMessage(message);
+                    [this, activationToken = AZStd::weak_ptr<bool>(m_activationToken)](const T& message)
+                    { // Possibly on an executor thread, where the handler must not be accessed
+                        ROS2Interface::Get()->QueueOnMainThread(
+                            [this, activationToken, message]()
+                            {
+                                if (activationToken.lock())
+                                {
+                                    OnControlMessage(message);
+                                }
+                            });
                     });
             }
         };
@@ -57,7 +68,9 @@ namespace ROS2
         void Deactivate() final
         {
             m_active = false;
+            m_activationToken.reset(); // Messages queued for the main thread are dropped
             m_controlSubscription.reset(); // Note: topic and qos can change, need to re-subscribe
+            m_ros2Node.reset(); // Held while subscribed, the node is destroyed with its last user
         };
 
         virtual ~ControlSubscriptionHandler() = default;
@@ -81,6 +94,9 @@ namespace ROS2
 
         AZ::EntityId m_entityId;
         bool m_active = false;
+        //! Owned while active. Messages queued for the main thread hold a weak reference and are dropped once it is released.
+        AZStd::shared_ptr<bool> m_activationToken;
+        std::shared_ptr<rclcpp::Node> m_ros2Node;
         typename rclcpp::Subscription<T>::SharedPtr m_controlSubscription;
     };
 } // namespace ROS2
@@ -12,15 +12,21 @@
 #include <AzCore/Component/Component.h>
 #include <AzCore/Component/TickBus.h>
 #include <AzCore/std/smart_ptr/unique_ptr.h>
+#include <AzFramework/Physics/Common/PhysicsTypes.h>
+#include <builtin_interfaces/msg/time.hpp>
+#include <rclcpp/node.hpp>
 
 namespace ROS2
 {
     //! Captures common behavior of ROS2 sensor Components.
     //! Sensors acquire data from the simulation engine and publish it to ROS2 ecosystem.
     //! Derive this Component to implement a new ROS2 sensor. Each sensor Component requires ROS2FrameComponent.
+    //! Sensors are sampled by the central sensor scheduler at their frequency, on the simulation time of their physics scene,
+    //! at the end of physics substeps. Frequencies higher than the frame rate are therefore sampled as configured, up to
+    //! the physics substep rate.
     class ROS2SensorComponent
         : public AZ::Component
-        , public AZ::TickBus::Handler // TODO - high resolution tick source?
+        , public AZ::TickBus::Handler
     {
     public:
         ROS2SensorComponent() = default;
@@ -34,21 +40,40 @@ namespace ROS2
         static void GetRequiredServices(AZ::ComponentDescriptor::DependencyArrayType& required);
 
     protected:
-        AZStd::string GetNamespace() const; //!< Get a complete namespace for this sensor topics and frame ids.
-        AZStd::string GetFrameID() const; //!< Already includes namespace.
+        const AZStd::string& GetNamespace() const; //!< Get a complete namespace for this sensor topics and frame ids.
+        const AZStd::string& GetFrameID() const; //!< Already includes namespace.
+        //! Physics scene of the sensor, on which simulation time it is sampled: the scene of its body, or the default one.
+        AzPhysics::SceneHandle GetPhysicsScene() const;
+        //! Simulation time since the previous sample, or since activation for the first one [s]. Valid in FrequencyTick.
+        double GetSampleInterval() const;
+        //! Time of the sample on the ROS clock, at the end of the physics substep it is taken after. Valid in FrequencyTick.
+        //! Stamp messages with it rather than with ROS2Requests::GetROSTimestamp, which is the same for all substeps of a frame.
+        builtin_interfaces::msg::Time GetSampleTimestamp() const;
+        //! Node of the sensor namespace to create publishers with. It is held by the sensor until it is deactivated.
+        //! @see ROS2Requests::GetNamespaceNode
+        std::shared_ptr<rclcpp::Node> GetNamespaceNode();
 
         SensorConfiguration m_sensorConfiguration;
 
     private:
         //! Executes the sensor action (acquire data -> publish) according to frequency.
+        //! Called on the main thread, after the physics substep the sensor is due in.
         //! Override to implement a specific sensor behavior.
         virtual void FrequencyTick(){};
 
         //! Visualise sensor operation.
         //! For example, draw points or rays for a lidar, viewport for a camera, etc.
-        //! Visualisation can be turned on or off in SensorConfiguration.
+        //! Called on each frame while the sensor is active, if visualisation is turned on in SensorConfiguration at activation.
         virtual void Visualise(){};
 
-        float m_timeElapsedSinceLastTick = 0.0f;
+        //! Called by the sensor scheduler when the sensor is due, @see SensorSchedulerRequests::AddSensor.
+        void OnSampleDue(double sampleTime, double sampleInterval);
+
+        AzPhysics::SceneHandle m_schedulePhysicsScene = AzPhysics::InvalidSceneHandle;
+        AZ::u64 m_scheduleSensorId = 0;
+        double m_timeSinceLastSample = 0.0; //!< Includes samples skipped while publishing is disabled.
+        double m_sampleInterval = 0.0;
+        double m_sampleTime = 0.0; //!< Time of the last sample on the ROS clock [s].
+        std::shared_ptr<rclcpp::Node> m_namespaceNode;
     };
 } // namespace ROS2
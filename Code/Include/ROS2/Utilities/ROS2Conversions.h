@@ -10,6 +10,7 @@
 #include <AzCore/Math/Quaternion.h>
 #include <AzCore/Math/Transform.h>
 #include <AzCore/Math/Vector3.h>
+#include <builtin_interfaces/msg/time.hpp>
 #include <geometry_msgs/msg/point.hpp>
 #include <geometry_msgs/msg/pose.hpp>
 #include <geometry_msgs/msg/vector3.hpp>
@@ -28,5 +29,7 @@ namespace ROS2
         static AZ::Transform FromROS2Pose(const geometry_msgs::msg::Pose& ros2pose);
         static AZ::Vector3 FromROS2Point(const geometry_msgs::msg::Point& ros2point);
         static AZ::Quaternion FromROS2Quaternion(const geometry_msgs::msg::Quaternion& ros2quaternion);
+        static builtin_interfaces::msg::Time ToROS2Time(double seconds); //!< Rounded to nanoseconds.
+        static double FromROS2Time(const builtin_interfaces::msg::Time& ros2time);
     };
 } // namespace ROS2
@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project.
+ * For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#include "CameraImageEncoder.h"
+#include <AzCore/Jobs/JobFunction.h>
+#include <AzCore/std/algorithm.h>
+#include <cstring>
+#include <zlib.h>
+
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
+namespace ROS2
+{
+    namespace Internal
+    {
+        constexpr int PngCompressionLevel = 3; //!< Default of compressed_image_transport, good ratio for little time.
+
+        const char* GetEncodingName(CameraImageEncoder::Encoding encoding)
+        {
+            switch (encoding)
+            {
+            case CameraImageEncoder::Encoding::Rgb8:
+                return "rgb8";
+            case CameraImageEncoder::Encoding::Bgr8:
+                return "bgr8";
+            default:
+                return "rgba8";
+            }
+        }
+
+        void WriteBigEndian(uint8_t* destination, uint32_t value)
+        {
+            destination[0] = static_cast<uint8_t>(value >> 24);
+            destination[1] = static_cast<uint8_t>(value >> 16);
+            destination[2] = static_cast<uint8_t>(value >> 8);
+            destination[3] = static_cast<uint8_t>(value);
+        }
+
+        //! Write the length, type and CRC of a PNG chunk, which has its data already written after the type.
+        //! @return Position after the chunk.
+        size_t WritePngChunk(std::vector<uint8_t>& png, size_t position, const char* type, uint32_t dataLength)
+        {
+            uint8_t* chunk = png.data() + position;
+            WriteBigEndian(chunk, dataLength);
+            memcpy(chunk + 4, type, 4);
+            const uLong crc = crc32(crc32(0L, Z_NULL, 0), chunk + 4, dataLength + 4); // Type and data
+            WriteBigEndian(chunk + 8 + dataLength, static_cast<uint32_t>(crc));
+            return position + 12 + dataLength;
+        }
+    } // namespace Internal
+
+    CameraImageEncoder::CameraImageEncoder(
+        const Configuration& configuration,
+        ImagePublisherPtrType imagePublisher,
+        CompressedImagePublisherPtrType compressedImagePublisher)
+        : m_configuration(configuration)
+        , m_imagePublisher(imagePublisher)
+        , m_compressedImagePublisher(compressedImagePublisher)
+    {
+        AZ_Assert(m_configuration.m_queueDepth > 0, "Queue must hold at least one frame");
+        AZ_Assert(
+            m_configuration.m_compression == Compression::None || m_compressedImagePublisher,
+            "Compressed image publisher is required for compression");
+    }
+
+    void CameraImageEncoder::QueueFrame(const AZ::RPI::AttachmentReadback::ReadbackResult& result, const std_msgs::msg::Header& header)
+    {
+        {
+            AZStd::lock_guard<AZStd::mutex> lock(m_queueMutex);
+            if (m_queue.size() >= m_configuration.m_queueDepth)
+            {
+                m_queue.pop_front();
+                m_statistics.m_droppedFrameCount++;
+            }
+            m_queue.push_back({ result.m_dataBuffer, result.m_imageDescriptor, header });
+            if (m_isEncoding)
+            { // Running job takes the frame when it finishes the current one
+                return;
+            }
+            m_isEncoding = true;
+        }
+
+        AZ::Job* encodingJob = AZ::CreateJobFunction(
+            [encoder = shared_from_this()]()
+            {
+                encoder->EncodeQueuedFrames();
+            },
+            true);
+        encodingJob->Start();
+    }
+
+    void CameraImageEncoder::SetImagePublishedCallback(ImagePublishedCallback imagePublishedCallback)
+    {
+        m_imagePublishedCallback = imagePublishedCallback;
+    }
+
+    CameraImageEncoder::Statistics CameraImageEncoder::GetStatistics() const
+    {
+        AZStd::lock_guard<AZStd::mutex> lock(m_queueMutex);
+        return m_statistics;
+    }
+
+    void CameraImageEncoder::EncodeQueuedFrames()
+    {
+        while (true)
+        {
+            Frame frame;
+            {
+                AZStd::lock_guard<AZStd::mutex> lock(m_queueMutex);
+                if (m_queue.empty())
+                {
+                    m_isEncoding = false;
+                    return;
+                }
+                frame = AZStd::move(m_queue.front());
+                m_queue.pop_front();
+            }
+            EncodeFrame(frame);
+
+            AZStd::lock_guard<AZStd::mutex> lock(m_queueMutex);
+            m_statistics.m_encodedFrameCount++;
+        }
+    }
+
+    void CameraImageEncoder::EncodeFrame(const Frame& frame)
+    {
+        const AZ::RHI::ImageDescriptor& descriptor = frame.m_descriptor;
+        if (descriptor.m_format != AZ::RHI::Format::R8G8B8A8_UNORM)
+        {
+            AZ_Error(
+                "CameraImageEncoder", false, "Only rgba8 images can be encoded, got format %u", static_cast<uint32_t>(descriptor.m_format));
+            return;
+        }
+
+        const uint32_t width = descriptor.m_size.m_width;
+        const uint32_t height = descriptor.m_size.m_height;
+        const size_t pixelCount = size_t{ width } * height;
+        AZ_Assert(frame.m_data->size() >= pixelCount * 4, "Readback is smaller than its descriptor");
+        const uint8_t* rgba = frame.m_data->data();
+
+        m_imageMessage.header = frame.m_header;
+        m_imageMessage.encoding = Internal::GetEncodingName(m_configuration.m_encoding);
+        m_imageMessage.width = width;
+        m_imageMessage.height = height;
+        if (m_configuration.m_encoding == Encoding::Rgba8)
+        {
+            m_imageMessage.step = width * 4;
+            m_imageMessage.data.resize(pixelCount * 4);
+            memcpy(m_imageMessage.data.data(), rgba, pixelCount * 4);
+        }
+        else
+        {
+            m_imageMessage.step = width * 3;
+            m_imageMessage.data.resize(pixelCount * 3);
+            ConvertRgbaToRgb(rgba, m_imageMessage.data.data(), pixelCount, m_configuration.m_encoding == Encoding::Bgr8);
+        }
+        m_imagePublisher->publish(m_imageMessage);
+        if (m_imagePublishedCallback)
+        {
+            m_imagePublishedCallback(frame.m_header);
+        }
+
+        if (m_configuration.m_compression == Compression::Png)
+        {
+            const uint8_t* rgb = m_imageMessage.data.data();
+            if (m_configuration.m_encoding != Encoding::Rgb8)
+            {
+                m_pngInput.resize(pixelCount * 3);
+                ConvertRgbaToRgb(rgba, m_pngInput.data(), pixelCount, false);
+                rgb = m_pngInput.data();
+            }
+
+            m_compressedImageMessage.header = frame.m_header;
+            m_compressedImageMessage.format = GetPngFormat(m_imageMessage.encoding);
+            if (EncodePng(rgb, width, height, m_pngFilteredRows, m_compressedImageMessage.data))
+            {
+                m_compressedImagePublisher->publish(m_compressedImageMessage);
+            }
+        }
+    }
+
+    std::string CameraImageEncoder::GetPngFormat(const std::string& encoding)
+    {
+        return encoding + "; png compressed bgr8";
+    }
+
+    void CameraImageEncoder::ConvertRgbaToRgb(const uint8_t* rgba, uint8_t* rgb, size_t pixelCount, bool swapRedAndBlue)
+    {
+        size_t i = 0;
+#if defined(__SSSE3__)
+        // Four pixels per shuffle. Each store writes 16 bytes, of which 12 are pixels and the rest is overwritten by the next
+        // store, so the vector loop stops while there is room for the whole store.
+        const __m128i shuffle = swapRedAndBlue ? _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1)
+                                               : _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+        for (; i + 6 <= pixelCount; i += 4)
+        {
+            const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgba + i * 4));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(rgb + i * 3), _mm_shuffle_epi8(pixels, shuffle));
+        }
+#endif
+        const size_t red = swapRedAndBlue ? 2 : 0;
+        const size_t blue = swapRedAndBlue ? 0 : 2;
+        for (; i < pixelCount; i++)
+        {
+            rgb[i * 3] = rgba[i * 4 + red];
+            rgb[i * 3 + 1] = rgba[i * 4 + 1];
+            rgb[i * 3 + 2] = rgba[i * 4 + blue];
+        }
+    }
+
+    bool CameraImageEncoder::EncodePng(
+        const uint8_t* rgb, uint32_t width, uint32_t height, std::vector<uint8_t>& filteredRows, std::vector<uint8_t>& png)
+    {
+        // Each row is prefixed with its filter type. Sub filter stores differences to the previous pixel, which
+        // compresses rendered images much better than raw values at a negligible cost.
+        constexpr uint8_t SubFilter = 1;
+        const size_t rowSize = size_t{ width } * 3;
+        filteredRows.resize((rowSize + 1) * height);
+        for (uint32_t y = 0; y < height; y++)
+        {
+            const uint8_t* row = rgb + y * rowSize;
+            uint8_t* filteredRow = filteredRows.data() + y * (rowSize + 1);
+            filteredRow[0] = SubFilter;
+            memcpy(filteredRow + 1, row, AZStd::min(rowSize, size_t{ 3 }));
+            for (size_t x = 3; x < rowSize; x++)
+            {
+                filteredRow[x + 1] = static_cast<uint8_t>(row[x] - row[x - 3]);
+            }
+        }
+
+        constexpr uint8_t Signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        constexpr uint32_t HeaderLength = 13;
+        constexpr size_t ChunkOverhead = 12; // Length, type and CRC
+        const uLong maxCompressedSize = compressBound(static_cast<uLong>(filteredRows.size()));
+        png.resize(sizeof(Signature) + (ChunkOverhead + HeaderLength) + (ChunkOverhead + maxCompressedSize) + ChunkOverhead);
+
+        memcpy(png.data(), Signature, sizeof(Signature));
+        size_t position = sizeof(Signature);
+
+        uint8_t* header = png.data() + position + 8;
+        Internal::WriteBigEndian(header, width);
+        Internal::WriteBigEndian(header + 4, height);
+        header[8] = 8; // Bit depth
+        header[9] = 2; // Color type: RGB
+        header[10] = 0; // Compression method: deflate
+        header[11] = 0; // Filter method: adaptive
+        header[12] = 0; // No interlace
+        position = Internal::WritePngChunk(png, position, "IHDR", HeaderLength);
+
+        uLongf compressedSize = maxCompressedSize;
+        const int result = compress2(
+            png.data() + position + 8,
+            &compressedSize,
+            filteredRows.data(),
+            static_cast<uLong>(filteredRows.size()),
+            Internal::PngCompressionLevel);
+        if (result != Z_OK)
+        {
+            AZ_Error("CameraImageEncoder", false, "PNG compression failed with error %d", result);
+            return false;
+        }
+        position = Internal::WritePngChunk(png, position, "IDAT", static_cast<uint32_t>(compressedSize));
+        position = Internal::WritePngChunk(png, position, "IEND", 0);
+        png.resize(position);
+        return true;
+    }
+} // namespace ROS2
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project.
+ * For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+#pragma once
+
+#include <Atom/Feature/Utils/FrameCaptureBus.h>
+#include <AzCore/std/containers/deque.h>
+#include <AzCore/std/functional.h>
+#include <AzCore/std/parallel/mutex.h>
+#include <AzCore/std/smart_ptr/enable_shared_from_this.h>
+#include <AzCore/std/smart_ptr/shared_ptr.h>
+#include <rclcpp/publisher.hpp>
+#include <sensor_msgs/msg/compressed_image.hpp>
+#include <sensor_msgs/msg/image.hpp>
+#include <std_msgs/msg/header.hpp>
+
+namespace ROS2
+{
+    //! Encoding stage of a color camera. Readback images are converted to the published encoding and optionally
+    //! compressed in jobs, on worker threads, and then published from there.
+    //! Frames of a camera are encoded in order, one at a time, while cameras are encoded in parallel.
+    //! Frames wait in a queue of limited depth; when it is full the oldest frame is dropped, so that a slow encoder
+    //! never holds back rendering and published frames stay recent.
+    class CameraImageEncoder : public AZStd::enable_shared_from_this<CameraImageEncoder>
+    {
+    public:
+        using ImagePublisherPtrType = std::shared_ptr<rclcpp::Publisher<sensor_msgs::msg::Image>>;
+        using CompressedImagePublisherPtrType = std::shared_ptr<rclcpp::Publisher<sensor_msgs::msg::CompressedImage>>;
+        using ImagePublishedCallback = AZStd::function<void(const std_msgs::msg::Header& header)>;
+
+        //! Encoding of published images.
+        enum Encoding
+        {
+            Rgba8, //!< As rendered.
+            Rgb8, //!< Alpha channel is dropped, which saves a quarter of the bandwidth.
+            Bgr8 //!< Alpha channel is dropped and channels are in the order expected by OpenCV.
+        };
+
+        //! Compression of images published on the compressed topic.
+        enum Compression
+        {
+            None, //!< Compressed topic is not published.
+            Png //!< Lossless PNG of the image, in the format of compressed_image_transport, see GetPngFormat.
+        };
+
+        struct Configuration
+        {
+            Encoding m_encoding = Encoding::Rgba8;
+            Compression m_compression = Compression::None;
+            size_t m_queueDepth = 2; //!< Maximum number of frames waiting for encoding.
+        };
+
+        struct Statistics
+        {
+            size_t m_encodedFrameCount = 0;
+            size_t m_droppedFrameCount = 0; //!< Frames dropped from the queue in favor of newer ones.
+        };
+
+        //! @param configuration - encoding and queue depth
+        //! @param imagePublisher - publisher of encoded images
+        //! @param compressedImagePublisher - publisher of compressed images, required unless compression is None
+        CameraImageEncoder(
+            const Configuration& configuration,
+            ImagePublisherPtrType imagePublisher,
+            CompressedImagePublisherPtrType compressedImagePublisher);
+
+        //! Queue a readback image for encoding and publishing. This returns immediately, the readback data is not copied.
+        //! @param result - readback of an rgba8 image
+        //! @param header - header of the published messages
+        void QueueFrame(const AZ::RPI::AttachmentReadback::ReadbackResult& result, const std_msgs::msg::Header& header);
+
+        //! Set a function called after each image is published, from the encoding job. Set it before queueing frames.
+        void SetImagePublishedCallback(ImagePublishedCallback imagePublishedCallback);
+
+        Statistics GetStatistics() const;
+
+        //! Convert rgba8 pixels to rgb8 or bgr8 pixels, dropping the alpha channel.
+        //! @param rgba - source pixels, 4 bytes each
+        //! @param rgb - destination pixels, 3 bytes each
+        //! @param swapRedAndBlue - produce bgr8 instead of rgb8
+        static void ConvertRgbaToRgb(const uint8_t* rgba, uint8_t* rgb, size_t pixelCount, bool swapRedAndBlue);
+
+        //! Encode an rgb8 image as PNG.
+        //! @param filteredRows - scratch buffer, reused between calls to avoid allocations
+        //! @param png - encoded file, replaces previous content
+        //! @return false if compression failed
+        static bool EncodePng(
+            const uint8_t* rgb, uint32_t width, uint32_t height, std::vector<uint8_t>& filteredRows, std::vector<uint8_t>& png);
+
+        //! Format of a PNG compressed image, as parsed by compressed_image_transport. The PNG holds true colours, which the
+        //! transport labels bgr8 because it decodes them with OpenCV.
+        //! @param encoding - encoding of the uncompressed image
+        static std::string GetPngFormat(const std::string& encoding);
+
+    private:
+        //! Readback image waiting in the queue. The readback buffer is shared, not copied.
+        struct Frame
+        {
+            AZStd::shared_ptr<AZStd::vector<uint8_t>> m_data;
+            AZ::RHI::ImageDescriptor m_descriptor;
+            std_msgs::msg::Header m_header;
+        };
+
+        //! Job function, encodes frames until the queue is empty.
+        void EncodeQueuedFrames();
+        void EncodeFrame(const Frame& frame);
+
+        const Configuration m_configuration;
+        ImagePublisherPtrType m_imagePublisher;
+        CompressedImagePublisherPtrType m_compressedImagePublisher;
+        ImagePublishedCallback m_imagePublishedCallback;
+
+        mutable AZStd::mutex m_queueMutex; //!< Guards the queue, the encoding flag and statistics.
+        AZStd::deque<Frame> m_queue;
+        bool m_isEncoding = false; //!< Whether an encoding job is running; only one is, so frames stay in order.
+        Statistics m_statistics;
+
+        // Used by the encoding job only. Messages are reused between frames so that buffers are not reallocated.
+        sensor_msgs::msg::Image m_imageMessage;
+        sensor_msgs::msg::CompressedImage m_compressedImageMessage;
+        std::vector<uint8_t> m_pngInput; //!< rgb8 image, when the published encoding is not rgb8.
+        std::vector<uint8_t> m_pngFilteredRows;
+    };
+} // namespace ROS2
@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project.
+ * For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#include "CameraPipeline.h"
+#include <Atom/RPI.Public/Pass/Specific/RenderToTexturePass.h>
+#include <Atom/RPI.Public/RPISystemInterface.h>
+#include <Atom/RPI.Public/RenderPipeline.h>
+#include <Atom/RPI.Public/Scene.h>
+#include <Atom/RPI.Public/View.h>
+#include <AzCore/Settings/SettingsRegistry.h>
+#include <AzCore/std/algorithm.h>
+#include <AzCore/std/smart_ptr/make_shared.h>
+#include <AzCore/std/smart_ptr/weak_ptr.h>
+#include <PostProcess/PostProcessFeatureProcessor.h>
+
+namespace ROS2
+{
+    namespace Internal
+    {
+        //! Pipeline pools by template and resolution. Camera sensors keep them alive, the cache only refers to them.
+        struct PipelinePoolEntry
+        {
+            AZStd::string m_templateName;
+            int m_width;
+            int m_height;
+            AZStd::weak_ptr<CameraPipelinePool> m_pool;
+        };
+
+        AZStd::vector<PipelinePoolEntry>& GetPipelinePoolCache()
+        {
+            static AZStd::vector<PipelinePoolEntry> cache;
+            return cache;
+        }
+    } // namespace Internal
+
+    CameraPipeline::CameraPipeline(const AZStd::string& pipelineName, const AZStd::string& templateName, int width, int height)
+        : m_name(pipelineName)
+    {
+        AZ_TracePrintf("CameraSensor", "Initializing pipeline %s", pipelineName.c_str());
+
+        const AZ::Name viewName = AZ::Name("MainCamera");
+        m_view = AZ::RPI::View::CreateView(viewName, AZ::RPI::View::UsageCamera);
+        m_scene = AZ::RPI::RPISystemInterface::Get()->GetSceneByName(AZ::Name("Main"));
+
+        AZ::RPI::RenderPipelineDescriptor pipelineDesc;
+        pipelineDesc.m_mainViewTagName = "MainCamera";
+        pipelineDesc.m_name = pipelineName;
+
+        pipelineDesc.m_rootPassTemplate = templateName;
+
+        pipelineDesc.m_renderSettings.m_multisampleState = AZ::RPI::RPISystemInterface::Get()->GetApplicationMultisampleState();
+        m_pipeline = AZ::RPI::RenderPipeline::CreateRenderPipeline(pipelineDesc);
+        m_pipeline->RemoveFromRenderTick();
+
+        if (auto renderToTexturePass = azrtti_cast<AZ::RPI::RenderToTexturePass*>(m_pipeline->GetRootPass().get()))
+        {
+            renderToTexturePass->ResizeOutput(width, height);
+        }
+
+        m_scene->AddRenderPipeline(m_pipeline);
+
+        m_pipeline->SetDefaultView(m_view);
+        const AZ::RPI::ViewPtr targetView = m_scene->GetDefaultRenderPipeline()->GetDefaultView();
+        if (auto* fp = m_scene->GetFeatureProcessor<AZ::Render::PostProcessFeatureProcessor>())
+        {
+            fp->SetViewAlias(m_view, targetView);
+        }
+    }
+
+    CameraPipeline::~CameraPipeline()
+    {
+        if (m_scene)
+        {
+            if (auto* fp = m_scene->GetFeatureProcessor<AZ::Render::PostProcessFeatureProcessor>())
+            {
+                fp->RemoveViewAlias(m_view);
+            }
+            m_scene->RemoveRenderPipeline(m_pipeline->GetId());
+            m_scene = nullptr;
+        }
+        m_pipeline.reset();
+        m_view.reset();
+    }
+
+    void CameraPipeline::RequestRender(const AZ::Matrix4x4& worldToView, const AZ::Matrix4x4& viewToClip)
+    {
+        m_view->SetViewToClipMatrix(viewToClip);
+        m_view->SetWorldToViewMatrix(worldToView);
+        m_pipeline->AddToRenderTickOnce();
+    }
+
+    bool CameraPipeline::IsRenderRequested() const
+    {
+        return m_pipeline->NeedsRender();
+    }
+
+    const AZStd::string& CameraPipeline::GetName() const
+    {
+        return m_name;
+    }
+
+    AZStd::shared_ptr<CameraPipelinePool> CameraPipelinePool::Get(const AZStd::string& templateName, int width, int height)
+    {
+        auto& cache = Internal::GetPipelinePoolCache();
+        auto cached = AZStd::find_if(
+            cache.begin(),
+            cache.end(),
+            [&](const Internal::PipelinePoolEntry& entry)
+            {
+                return entry.m_templateName == templateName && entry.m_width == width && entry.m_height == height;
+            });
+        if (cached != cache.end())
+        {
+            if (auto pool = cached->m_pool.lock())
+            {
+                return pool;
+            }
+        }
+
+        auto pool = AZStd::make_shared<CameraPipelinePool>(templateName, width, height);
+        if (cached != cache.end())
+        {
+            cached->m_pool = pool;
+        }
+        else
+        {
+            cache.push_back({ templateName, width, height, pool });
+        }
+        return pool;
+    }
+
+    CameraPipelinePool::CameraPipelinePool(const AZStd::string& templateName, int width, int height)
+        : m_templateName(templateName)
+        , m_width(width)
+        , m_height(height)
+    {
+        AZ::u64 maxPipelineCount = 1;
+        if (auto* settingsRegistry = AZ::SettingsRegistry::Get())
+        {
+            settingsRegistry->Get(maxPipelineCount, SharedPipelineCountRegistryPath);
+        }
+        m_maxPipelineCount = AZStd::max(static_cast<size_t>(maxPipelineCount), size_t{ 1 });
+    }
+
+    CameraPipeline* CameraPipelinePool::AcquirePipeline(const void* requester)
+    {
+        auto waitingIt = AZStd::find(m_waitingRequesters.begin(), m_waitingRequesters.end(), requester);
+        const auto waitingAheadCount = static_cast<size_t>(AZStd::distance(m_waitingRequesters.begin(), waitingIt));
+        size_t freePipelineCount = m_maxPipelineCount - m_pipelines.size();
+        CameraPipeline* freePipeline = nullptr;
+        for (const auto& pipeline : m_pipelines)
+        {
+            if (!pipeline->IsRenderRequested())
+            {
+                freePipelineCount++;
+                freePipeline = freePipeline ? freePipeline : pipeline.get();
+            }
+        }
+
+        if (freePipelineCount <= waitingAheadCount)
+        { // Left to requesters which waited longer, and request again later in this frame
+            if (waitingIt == m_waitingRequesters.end())
+            {
+                m_waitingRequesters.push_back(requester);
+            }
+            return nullptr;
+        }
+        if (waitingIt != m_waitingRequesters.end())
+        {
+            m_waitingRequesters.erase(waitingIt);
+        }
+        if (freePipeline)
+        {
+            return freePipeline;
+        }
+
+        const AZStd::string pipelineName = AZStd::string::format(
+            "ROS2SharedCamera%s_%dx%d_%zu", m_templateName.c_str(), m_width, m_height, m_pipelines.size());
+        m_pipelines.push_back(AZStd::make_unique<CameraPipeline>(pipelineName, m_templateName, m_width, m_height));
+        return m_pipelines.back().get();
+    }
+
+    void CameraPipelinePool::CancelAcquire(const void* requester)
+    {
+        m_waitingRequesters.erase(
+            AZStd::remove(m_waitingRequesters.begin(), m_waitingRequesters.end(), requester), m_waitingRequesters.end());
+    }
+} // namespace ROS2
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project.
+ * For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+#pragma once
+
+#include <Atom/RPI.Public/Base.h>
+#include <AzCore/Math/Matrix4x4.h>
+#include <AzCore/std/containers/vector.h>
+#include <AzCore/std/smart_ptr/shared_ptr.h>
+#include <AzCore/std/smart_ptr/unique_ptr.h>
+#include <AzCore/std/string/string.h>
+
+namespace ROS2
+{
+    //! Render pipeline of camera sensors in the main scene, rendering to a texture of the camera resolution.
+    //! It renders only when requested, from the view set with the request.
+    class CameraPipeline
+    {
+    public:
+        //! @param pipelineName - unique name of the pipeline, the root of pass hierarchies of its readbacks
+        //! @param templateName - root pass template of the pipeline
+        //! @param width - output width in pixels
+        //! @param height - output height in pixels
+        CameraPipeline(const AZStd::string& pipelineName, const AZStd::string& templateName, int width, int height);
+        ~CameraPipeline();
+
+        //! Set the view and render the pipeline once, in the next render tick.
+        void RequestRender(const AZ::Matrix4x4& worldToView, const AZ::Matrix4x4& viewToClip);
+
+        //! Whether the pipeline is already requested to render in the next render tick, so it is not available for another view.
+        bool IsRenderRequested() const;
+
+        const AZStd::string& GetName() const;
+
+    private:
+        AZStd::string m_name;
+        AZ::RPI::RenderPipelinePtr m_pipeline;
+        AZ::RPI::ViewPtr m_view;
+        AZ::RPI::Scene* m_scene = nullptr;
+    };
+
+    //! Pipelines shared by camera sensors with the same pipeline template and resolution.
+    //! Each pipeline renders one camera per frame, so cameras due in the same frame take different pipelines, and cameras
+    //! which find no free pipeline render in a following frame. Sensors of a multi-camera rig, which publish at a fraction
+    //! of the frame rate, thus render through a few pipelines instead of one each.
+    //! Cameras which find no free pipeline wait in a queue, and are handed pipelines in the order they started waiting,
+    //! so that cameras which happen to request early in each frame do not starve the others.
+    //! The number of pipelines in a pool is read from the settings registry at SharedPipelineCountRegistryPath, one by default.
+    class CameraPipelinePool
+    {
+    public:
+        static constexpr const char* SharedPipelineCountRegistryPath = "/O3DE/ROS2/Camera/SharedPipelineCount";
+
+        //! Get the pool of a pipeline template and resolution, shared by all cameras using it. Call from the main thread.
+        static AZStd::shared_ptr<CameraPipelinePool> Get(const AZStd::string& templateName, int width, int height);
+
+        CameraPipelinePool(const AZStd::string& templateName, int width, int height);
+
+        //! Get a pipeline which is not yet requested to render in the next render tick. Pipelines are created on first use.
+        //! A requester which gets no pipeline is queued, and keeps its place while it requests again in following frames.
+        //! @param requester - identifies the camera sensor requesting the pipeline
+        //! @return Free pipeline, or nullptr if all free pipelines are requested or left to requesters which waited longer
+        CameraPipeline* AcquirePipeline(const void* requester);
+
+        //! Leave the queue of requesters waiting for a pipeline, when a requester no longer requests again in following frames.
+        void CancelAcquire(const void* requester);
+
+    private:
+        AZStd::string m_templateName;
+        int m_width;
+        int m_height;
+        size_t m_maxPipelineCount = 1;
+        AZStd::vector<AZStd::unique_ptr<CameraPipeline>> m_pipelines;
+        AZStd::vector<const void*> m_waitingRequesters; //!< Requesters which got no pipeline, the longest waiting first.
+    };
+} // namespace ROS2
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project.
+ * For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#include "CameraPointCloud.h"
+#include <limits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace ROS2
+{
+    CameraPointCloud::CameraPointCloud(
+        const AZStd::array<double, 9>& cameraIntrinsics, int width, int height, float maxDepth, PointCloudPublisherPtrType publisher)
+        : m_maxDepth(maxDepth)
+        , m_publisher(publisher)
+    {
+        MakeRayTable(cameraIntrinsics, width, height, m_rays);
+
+        constexpr const char* FieldNames[] = { "x", "y", "z" };
+        for (uint32_t i = 0; i < 3; i++)
+        {
+            sensor_msgs::msg::PointField field;
+            field.name = FieldNames[i];
+            field.offset = i * sizeof(float);
+            field.datatype = sensor_msgs::msg::PointField::FLOAT32;
+            field.count = 1;
+            m_message.fields.push_back(field);
+        }
+        m_message.is_bigendian = false;
+        m_message.is_dense = false; // Pixels without a surface are NaN points
+        m_message.width = width;
+        m_message.height = height;
+        m_message.point_step = 3 * sizeof(float);
+        m_message.row_step = m_message.width * m_message.point_step;
+        m_message.data.resize(m_message.row_step * m_message.height);
+    }
+
+    void CameraPointCloud::Publish(const AZ::RPI::AttachmentReadback::ReadbackResult& result, const std_msgs::msg::Header& header)
+    {
+        const AZ::RHI::ImageDescriptor& descriptor = result.m_imageDescriptor;
+        if (descriptor.m_format != AZ::RHI::Format::R32_FLOAT || descriptor.m_size.m_width != m_message.width ||
+            descriptor.m_size.m_height != m_message.height)
+        {
+            AZ_ErrorOnce("CameraPointCloud", false, "Depth readback does not match the camera, no point cloud is published");
+            return;
+        }
+
+        const size_t pixelCount = size_t{ m_message.width } * m_message.height;
+        AZ_Assert(result.m_dataBuffer->size() >= pixelCount * sizeof(float), "Readback is smaller than its descriptor");
+        ConvertDepthToPoints(
+            reinterpret_cast<const float*>(result.m_dataBuffer->data()),
+            m_rays.data(),
+            pixelCount,
+            m_maxDepth,
+            reinterpret_cast<float*>(m_message.data.data()));
+        m_message.header = header;
+        m_publisher->publish(m_message);
+    }
+
+    void CameraPointCloud::MakeRayTable(const AZStd::array<double, 9>& cameraIntrinsics, int width, int height, std::vector<float>& rays)
+    {
+        const double focalLengthX = cameraIntrinsics[0];
+        const double principalPointX = cameraIntrinsics[2];
+        const double focalLengthY = cameraIntrinsics[4];
+        const double principalPointY = cameraIntrinsics[5];
+        rays.resize(size_t{ 3 } * width * height);
+        float* ray = rays.data();
+        for (int v = 0; v < height; v++)
+        {
+            const float y = static_cast<float>((v + 0.5 - principalPointY) / focalLengthY);
+            for (int u = 0; u < width; u++)
+            {
+                ray[0] = static_cast<float>((u + 0.5 - principalPointX) / focalLengthX);
+                ray[1] = y;
+                ray[2] = 1.0f;
+                ray += 3;
+            }
+        }
+    }
+
+    void CameraPointCloud::ConvertDepthToPoints(const float* depth, const float* rays, size_t pixelCount, float maxDepth, float* points)
+    {
+        size_t i = 0;
+#if defined(__SSE2__)
+        // Four pixels are twelve floats, three vectors of rays and points. Depths are spread over them to match ray components.
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 max = _mm_set1_ps(maxDepth);
+        const __m128 nan = _mm_set1_ps(std::numeric_limits<float>::quiet_NaN());
+        for (; i + 4 <= pixelCount; i += 4)
+        {
+            const __m128 depths = _mm_loadu_ps(depth + i);
+            const __m128 isValid = _mm_and_ps(_mm_cmpgt_ps(depths, zero), _mm_cmplt_ps(depths, max));
+            const __m128 validDepths = _mm_or_ps(_mm_and_ps(isValid, depths), _mm_andnot_ps(isValid, nan));
+            const __m128 scales[3] = { _mm_shuffle_ps(validDepths, validDepths, _MM_SHUFFLE(1, 0, 0, 0)),
+                                       _mm_shuffle_ps(validDepths, validDepths, _MM_SHUFFLE(2, 2, 1, 1)),
+                                       _mm_shuffle_ps(validDepths, validDepths, _MM_SHUFFLE(3, 3, 3, 2)) };
+            for (size_t j = 0; j < 3; j++)
+            {
+                const __m128 ray = _mm_loadu_ps(rays + i * 3 + j * 4);
+                _mm_storeu_ps(points + i * 3 + j * 4, _mm_mul_ps(ray, scales[j]));
+            }
+        }
+#endif
+        for (; i < pixelCount; i++)
+        {
+            const float pixelDepth = depth[i] > 0.0f && depth[i] < maxDepth ? depth[i] : std::numeric_limits<float>::quiet_NaN();
+            points[i * 3] = rays[i * 3] * pixelDepth;
+            points[i * 3 + 1] = rays[i * 3 + 1] * pixelDepth;
+            points[i * 3 + 2] = rays[i * 3 + 2] * pixelDepth;
+        }
+    }
+} // namespace ROS2
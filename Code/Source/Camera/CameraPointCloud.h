@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project.
+ * For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+#pragma once
+
+#include <Atom/Feature/Utils/FrameCaptureBus.h>
+#include <AzCore/std/containers/array.h>
+#include <rclcpp/publisher.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
+#include <std_msgs/msg/header.hpp>
+
+namespace ROS2
+{
+    //! Organized point cloud reprojected from linear depth images of a camera, so that consumers do not reproject each image.
+    //! Each pixel has a precomputed ray through its center, with unit depth, so a point is its ray scaled by the pixel depth.
+    //! Points are in the camera optical frame (x right, y down, z forward), the frame of published images.
+    //! Pixels without a surface in range are NaN points, and rows and columns of the cloud are those of the image.
+    class CameraPointCloud
+    {
+    public:
+        using PointCloudPublisherPtrType = std::shared_ptr<rclcpp::Publisher<sensor_msgs::msg::PointCloud2>>;
+
+        //! @param cameraIntrinsics - row-major intrinsic matrix of the camera, as in CameraSensorDescription
+        //! @param width - image width in pixels
+        //! @param height - image height in pixels
+        //! @param maxDepth - depth of the far clip plane, pixels at or beyond it have no surface
+        //! @param publisher - publisher of point clouds
+        CameraPointCloud(
+            const AZStd::array<double, 9>& cameraIntrinsics, int width, int height, float maxDepth, PointCloudPublisherPtrType publisher);
+
+        //! Reproject a depth readback and publish it. Call from readback callbacks, which are called one at a time.
+        //! @param result - readback of a 32-bit float linear depth image of the configured size
+        //! @param header - header of the published message, that of the depth image
+        void Publish(const AZ::RPI::AttachmentReadback::ReadbackResult& result, const std_msgs::msg::Header& header);
+
+        //! Compute rays through pixel centers, three floats per pixel, in row-major pixel order.
+        static void MakeRayTable(const AZStd::array<double, 9>& cameraIntrinsics, int width, int height, std::vector<float>& rays);
+
+        //! Scale rays by depths into points of three floats each. Depths which are not in (0, maxDepth) give NaN points.
+        static void ConvertDepthToPoints(const float* depth, const float* rays, size_t pixelCount, float maxDepth, float* points);
+
+    private:
+        std::vector<float> m_rays;
+        const float m_maxDepth;
+        PointCloudPublisherPtrType m_publisher;
+        sensor_msgs::msg::PointCloud2 m_message; //!< Reused between frames so that its buffer is not reallocated.
+    };
+} // namespace ROS2
@@ -8,9 +8,11 @@
 #include "CameraSensor.h"
 
 #include <AzCore/Math/MatrixUtils.h>
+#include <AzCore/std/algorithm.h>
+#include <AzCore/std/smart_ptr/make_shared.h>
+#include <cstring>
 
 #include <Atom/RPI.Public/Base.h>
-#include <Atom/RPI.Public/Pass/Specific/RenderToTexturePass.h>
 #include <Atom/RPI.Public/RPISystemInterface.h>
 #include <Atom/RPI.Public/RenderPipeline.h>
 #include <Atom/RPI.Public/Scene.h>
@@ -19,7 +21,6 @@
 
 #include <Atom/RPI.Public/FeatureProcessorFactory.h>
 #include <Atom/RPI.Public/Pass/PassSystemInterface.h>
-#include <PostProcess/PostProcessFeatureProcessor.h>
 
 #include <Atom/RPI.Public/Pass/PassFactory.h>
 
@@ -28,34 +29,46 @@ namespace ROS2
     namespace Internal
     {
 
-        /// @FormatMappings - contains the mapping from RHI to ROS image encodings. List of supported
-        /// ROS image encodings lives in `sensor_msgs/image_encodings.hpp'
-        /// We are not including `image_encodings.hpp` since it uses exceptions.
-        AZStd::unordered_map<AZ::RHI::Format, const char*> FormatMappings{
-            { AZ::RHI::Format::R8G8B8A8_UNORM, "rgba8" },     { AZ::RHI::Format::R16G16B16A16_UNORM, "rgba16" },
-            { AZ::RHI::Format::R32G32B32A32_FLOAT, "32FC4" }, // Unsuported by RVIZ2
-            { AZ::RHI::Format::R8_UNORM, "mono8" },           { AZ::RHI::Format::R16_UNORM, "mono16" },
-            { AZ::RHI::Format::R32_FLOAT, "32FC1" },
+        //! ROS image encoding and pixel size of a readback format.
+        struct ImageFormat
+        {
+            const char* m_encoding = nullptr; //!< One of encodings listed in `sensor_msgs/image_encodings.hpp`.
+            uint32_t m_bytesPerPixel = 0; //!< Used in `step` size computation, like `bitDepth()` of `image_encodings.hpp`.
         };
 
-        /// @BitDepth - contains the mapping from RHI to size used in `step` size computation.
-        /// It is some equivalent to `bitDepth()` function from `sensor_msgs/image_encodings.hpp`
-        AZStd::unordered_map<AZ::RHI::Format, int> BitDepth{
-            { AZ::RHI::Format::R8G8B8A8_UNORM, 4 * sizeof(uint8_t) },
-            { AZ::RHI::Format::R16G16B16A16_UNORM, 4 * sizeof(uint16_t) },
-            { AZ::RHI::Format::R32G32B32A32_FLOAT, 4 * sizeof(float) }, // Unsuported by RVIZ2
-            { AZ::RHI::Format::R8_UNORM, sizeof(uint8_t) },
-            { AZ::RHI::Format::R16_UNORM, sizeof(uint16_t) },
-            { AZ::RHI::Format::R32_FLOAT, sizeof(float) },
-        };
+        //! Map RHI formats of camera pipeline outputs to ROS image encodings.
+        //! We are not including `image_encodings.hpp` since it uses exceptions.
+        //! @return Image format, with no encoding if the format is not supported.
+        ImageFormat GetImageFormat(AZ::RHI::Format format)
+        {
+            switch (format)
+            {
+            case AZ::RHI::Format::R8G8B8A8_UNORM:
+                return { "rgba8", 4 * sizeof(uint8_t) };
+            case AZ::RHI::Format::R16G16B16A16_UNORM:
+                return { "rgba16", 4 * sizeof(uint16_t) };
+            case AZ::RHI::Format::R32G32B32A32_FLOAT:
+                return { "32FC4", 4 * sizeof(float) }; // Unsuported by RVIZ2
+            case AZ::RHI::Format::R8_UNORM:
+                return { "mono8", sizeof(uint8_t) };
+            case AZ::RHI::Format::R16_UNORM:
+                return { "mono16", sizeof(uint16_t) };
+            case AZ::RHI::Format::R32_FLOAT:
+                return { "32FC1", sizeof(float) };
+            default:
+                return {};
+            }
+        }
 
     } // namespace Internal
-    CameraSensorDescription::CameraSensorDescription(const AZStd::string& cameraName, float verticalFov, int width, int height)
+    CameraSensorDescription::CameraSensorDescription(
+        const AZStd::string& cameraName, float verticalFov, int width, int height, bool useSharedPipeline)
         : m_verticalFieldOfViewDeg(verticalFov)
         , m_verticalFieldOfViewRad(AZ::DegToRad(m_verticalFieldOfViewDeg))
         , m_width(width)
         , m_height(height)
         , m_cameraName(cameraName)
+        , m_useSharedPipeline(useSharedPipeline)
         , m_aspectRatio(static_cast<float>(width) / static_cast<float>(height))
         , m_viewToClipMatrix(MakeViewToClipMatrix())
         , m_cameraIntrinsics(MakeCameraIntrinsics())
@@ -65,10 +78,9 @@ namespace ROS2
 
     AZ::Matrix4x4 CameraSensorDescription::MakeViewToClipMatrix() const
     {
-        const float nearDist = 0.1f, farDist = 100.0f;
         AZ::Matrix4x4 localViewToClipMatrix;
         AZ::MakePerspectiveFovMatrixRH(
-            localViewToClipMatrix, AZ::DegToRad(m_verticalFieldOfViewDeg), m_aspectRatio, nearDist, farDist, true);
+            localViewToClipMatrix, AZ::DegToRad(m_verticalFieldOfViewDeg), m_aspectRatio, NearClipDistance, FarClipDistance, true);
         return localViewToClipMatrix;
     }
 
@@ -101,80 +113,183 @@ namespace ROS2
 
     CameraSensor::CameraSensor(const CameraSensorDescription& cameraSensorDescription)
         : m_cameraSensorDescription(cameraSensorDescription)
+        , m_frameOutput(AZStd::make_shared<FrameOutput>())
+        , m_captureTracker(AZStd::make_shared<CaptureTracker>())
     {
     }
 
     void CameraSensor::setupPasses()
     {
-        AZ_TracePrintf("CameraSensor", "Initializing pipeline for %s", m_cameraSensorDescription.m_cameraName.c_str());
-
-        const AZ::Name viewName = AZ::Name("MainCamera");
-        m_view = AZ::RPI::View::CreateView(viewName, AZ::RPI::View::UsageCamera);
-        m_view->SetViewToClipMatrix(m_cameraSensorDescription.m_viewToClipMatrix);
-        m_scene = AZ::RPI::RPISystemInterface::Get()->GetSceneByName(AZ::Name("Main"));
+        const AZStd::string templateName = getPipelineTemplateName();
+        const int width = m_cameraSensorDescription.m_width;
+        const int height = m_cameraSensorDescription.m_height;
+        if (m_cameraSensorDescription.m_useSharedPipeline)
+        {
+            AZ_TracePrintf("CameraSensor", "Using shared pipelines for %s", m_cameraSensorDescription.m_cameraName.c_str());
+            m_pipelinePool = CameraPipelinePool::Get(templateName, width, height);
+            return;
+        }
 
         const AZStd::string pipelineName = m_cameraSensorDescription.m_cameraName + "Pipeline" + getPipelineTypeName();
+        m_ownPipeline = AZStd::make_unique<CameraPipeline>(pipelineName, templateName, width, height);
+    }
 
-        AZ::RPI::RenderPipelineDescriptor pipelineDesc;
-        pipelineDesc.m_mainViewTagName = "MainCamera";
-        pipelineDesc.m_name = pipelineName;
-
-        pipelineDesc.m_rootPassTemplate = getPipelineTemplateName();
-
-        pipelineDesc.m_renderSettings.m_multisampleState = AZ::RPI::RPISystemInterface::Get()->GetApplicationMultisampleState();
-        m_pipeline = AZ::RPI::RenderPipeline::CreateRenderPipeline(pipelineDesc);
-        m_pipeline->RemoveFromRenderTick();
-
-        if (auto renderToTexturePass = azrtti_cast<AZ::RPI::RenderToTexturePass*>(m_pipeline->GetRootPass().get()))
+    CameraSensor::~CameraSensor()
+    {
+        m_framePipeline = nullptr;
+        m_ownPipeline.reset();
+        if (m_pipelinePool)
         {
-            renderToTexturePass->ResizeOutput(m_cameraSensorDescription.m_width, m_cameraSensorDescription.m_height);
+            m_pipelinePool->CancelAcquire(this);
         }
+        m_pipelinePool.reset();
+    }
 
-        m_scene->AddRenderPipeline(m_pipeline);
-
-        m_passHierarchy.push_back(pipelineName);
-        m_passHierarchy.push_back("CopyToSwapChain");
-
-        m_pipeline->SetDefaultView(m_view);
-        const AZ::RPI::ViewPtr targetView = m_scene->GetDefaultRenderPipeline()->GetDefaultView();
-        if (auto* fp = m_scene->GetFeatureProcessor<AZ::Render::PostProcessFeatureProcessor>())
+    void CameraSensor::CaptureTracker::CompleteFrame(AZStd::chrono::steady_clock::time_point requestTime)
+    {
+        const auto latency = AZStd::chrono::steady_clock::now() - requestTime;
+        const AZ::u64 latencyUs = AZStd::chrono::duration_cast<AZStd::chrono::microseconds>(latency).count();
+        m_totalLatencyUs += latencyUs;
+        AZ::u64 maxLatencyUs = m_maxLatencyUs;
+        while (latencyUs > maxLatencyUs && !m_maxLatencyUs.compare_exchange_weak(maxLatencyUs, latencyUs))
         {
-            fp->SetViewAlias(m_view, targetView);
         }
+        m_completedFrameCount++;
+        m_inFlightFrameCount--;
     }
 
-    CameraSensor::~CameraSensor()
+    bool CameraSensor::RequestFrame(const AZ::Transform& cameraPose, ReadbackCallback callback)
     {
-        if (m_scene)
-        {
-            if (auto* fp = m_scene->GetFeatureProcessor<AZ::Render::PostProcessFeatureProcessor>())
+        if (m_captureTracker->m_inFlightFrameCount >= m_maxCapturesInFlight)
+        { // Renderer is behind, another request would only be published later than the ones waiting
+            if (m_isWaitingForPipeline)
             {
-                fp->RemoveViewAlias(m_view);
+                m_pipelinePool->CancelAcquire(this);
+                m_isWaitingForPipeline = false;
             }
-            m_scene->RemoveRenderPipeline(m_pipeline->GetId());
-            m_scene = nullptr;
+            m_skippedFrameCount++;
+            return false;
+        }
+
+        CameraPipeline* pipeline = m_ownPipeline.get();
+        if (m_pipelinePool)
+        {
+            pipeline = m_pipelinePool->AcquirePipeline(this);
+            m_isWaitingForPipeline = pipeline == nullptr;
+            if (m_isWaitingForPipeline)
+            { // Shared pipelines are taken by other cameras in this frame, the frame can be requested again in the next one
+                return false;
+            }
+        }
+        else if (pipeline->IsRenderRequested())
+        { // Already requested in this frame
+            m_skippedFrameCount++;
+            return false;
         }
-        m_passHierarchy.clear();
-        m_pipeline.reset();
-        m_view.reset();
-    }
 
-    void CameraSensor::RequestFrame(
-        const AZ::Transform& cameraPose, AZStd::function<void(const AZ::RPI::AttachmentReadback::ReadbackResult& result)> callback)
-    {
         const AZ::Transform inverse = (cameraPose * kAtomToRos).GetInverse();
-        m_view->SetWorldToViewMatrix(AZ::Matrix4x4::CreateFromQuaternionAndTranslation(inverse.GetRotation(), inverse.GetTranslation()));
+        pipeline->RequestRender(
+            AZ::Matrix4x4::CreateFromQuaternionAndTranslation(inverse.GetRotation(), inverse.GetTranslation()),
+            m_cameraSensorDescription.m_viewToClipMatrix);
+        m_framePipeline = pipeline;
+
+        m_captureTracker->m_inFlightFrameCount++;
+        const AZStd::vector<AZStd::string> passHierarchy{ pipeline->GetName(), "CopyToSwapChain" };
+        const bool isRequested = RequestAttachment(
+            passHierarchy,
+            AZStd::string("Output"),
+            [callback = AZStd::move(callback), captureTracker = m_captureTracker, requestTime = AZStd::chrono::steady_clock::now()](
+                const AZ::RPI::AttachmentReadback::ReadbackResult& result)
+            {
+                callback(result);
+                captureTracker->CompleteFrame(requestTime);
+            });
+        if (!isRequested)
+        {
+            m_captureTracker->m_inFlightFrameCount--;
+            m_skippedFrameCount++;
+            return false;
+        }
+        m_requestedFrameCount++;
+        return true;
+    }
 
+    bool CameraSensor::RequestAttachment(
+        const AZStd::vector<AZStd::string>& passHierarchy, const AZStd::string& slotName, ReadbackCallback callback)
+    {
         AZ::Render::FrameCaptureId captureId = AZ::Render::InvalidFrameCaptureId;
-
-        m_pipeline->AddToRenderTickOnce();
         AZ::Render::FrameCaptureRequestBus::BroadcastResult(
             captureId,
             &AZ::Render::FrameCaptureRequestBus::Events::CapturePassAttachmentWithCallback,
-            m_passHierarchy,
-            AZStd::string("Output"),
+            passHierarchy,
+            slotName,
             callback,
             AZ::RPI::PassAttachmentReadbackOption::Output);
+        AZ_WarningOnce("CameraSensor", captureId != AZ::Render::InvalidFrameCaptureId, "Capture of %s was not requested", slotName.c_str());
+        return captureId != AZ::Render::InvalidFrameCaptureId;
+    }
+
+    void CameraSensor::SetImageEncoder(AZStd::shared_ptr<CameraImageEncoder> imageEncoder)
+    {
+        m_imageEncoder = imageEncoder;
+    }
+
+    void CameraSensor::SetImagePublishedCallback(ImagePublishedCallback imagePublishedCallback)
+    {
+        m_imagePublishedCallback = imagePublishedCallback;
+        if (m_imageEncoder)
+        {
+            m_imageEncoder->SetImagePublishedCallback(imagePublishedCallback);
+        }
+    }
+
+    void CameraSensor::SetMaxCapturesInFlight(AZ::u32 maxCapturesInFlight)
+    {
+        m_maxCapturesInFlight = AZStd::max(maxCapturesInFlight, 1u);
+    }
+
+    void CameraSensor::SetPointCloudPublisher(CameraPointCloud::PointCloudPublisherPtrType pointCloudPublisher)
+    {
+        m_pointCloud = AZStd::make_shared<CameraPointCloud>(
+            m_cameraSensorDescription.m_cameraIntrinsics,
+            m_cameraSensorDescription.m_width,
+            m_cameraSensorDescription.m_height,
+            CameraSensorDescription::FarClipDistance,
+            pointCloudPublisher);
+    }
+
+    bool CameraSensor::IsWaitingForPipeline() const
+    {
+        return m_isWaitingForPipeline;
+    }
+
+    void CameraSensor::SkipWaitingFrame(bool keepWaiting)
+    {
+        if (!m_isWaitingForPipeline)
+        {
+            return;
+        }
+        m_skippedFrameCount++;
+        if (!keepWaiting)
+        {
+            m_pipelinePool->CancelAcquire(this);
+            m_isWaitingForPipeline = false;
+        }
+    }
+
+    CameraCaptureStatistics CameraSensor::GetCaptureStatistics() const
+    {
+        CameraCaptureStatistics statistics;
+        statistics.m_requestedFrameCount = m_requestedFrameCount;
+        statistics.m_skippedFrameCount = m_skippedFrameCount;
+        statistics.m_completedFrameCount = m_captureTracker->m_completedFrameCount;
+        statistics.m_inFlightFrameCount = m_captureTracker->m_inFlightFrameCount;
+        if (statistics.m_completedFrameCount > 0)
+        {
+            statistics.m_averageLatencyMs = 1e-3f * m_captureTracker->m_totalLatencyUs / statistics.m_completedFrameCount;
+        }
+        statistics.m_maxLatencyMs = 1e-3f * m_captureTracker->m_maxLatencyUs;
+        return statistics;
     }
 
     const CameraSensorDescription& CameraSensor::GetCameraSensorDescription() const
@@ -182,27 +297,81 @@ namespace ROS2
         return m_cameraSensorDescription;
     }
 
-    void CameraSensor::publishMassage(
-        std::shared_ptr<rclcpp::Publisher<sensor_msgs::msg::Image>> publisher,
-        const AZ::Transform& cameraPose,
-        const std_msgs::msg::Header& header)
+    const AZStd::string& CameraSensor::GetFramePipelineName() const
     {
-        RequestFrame(
-            cameraPose,
-            [header, publisher](const AZ::RPI::AttachmentReadback::ReadbackResult& result)
-            {
-                const AZ::RHI::ImageDescriptor& descriptor = result.m_imageDescriptor;
-                const auto format = descriptor.m_format;
-                AZ_Assert(Internal::FormatMappings.contains(format), "Unknown format in result %u", static_cast<uint32_t>(format));
-                sensor_msgs::msg::Image message;
-                message.encoding = Internal::FormatMappings.at(format);
+        AZ_Assert(m_framePipeline, "No frame was requested");
+        return m_framePipeline->GetName();
+    }
+
+    CameraSensor::ReadbackCallback CameraSensor::MakePublishingCallback(
+        ImagePublisherPtrType publisher,
+        const std_msgs::msg::Header& header,
+        AZStd::shared_ptr<FrameOutput> frameOutput,
+        ImagePublishedCallback imagePublished)
+    {
+        return [header, publisher, frameOutput, imagePublished](const AZ::RPI::AttachmentReadback::ReadbackResult& result)
+        {
+            const AZ::RHI::ImageDescriptor& descriptor = result.m_imageDescriptor;
+            sensor_msgs::msg::Image& message = frameOutput->m_message;
+            if (descriptor.m_format != frameOutput->m_format || descriptor.m_size.m_width != message.width ||
+                descriptor.m_size.m_height != message.height)
+            { // Metadata is fixed by the pipeline output, so it is only resolved for the first frame
+                const Internal::ImageFormat imageFormat = Internal::GetImageFormat(descriptor.m_format);
+                if (!imageFormat.m_encoding)
+                {
+                    AZ_Error("CameraSensor", false, "Unknown format in result %u", static_cast<uint32_t>(descriptor.m_format));
+                    return;
+                }
+                frameOutput->m_format = descriptor.m_format;
+                message.encoding = imageFormat.m_encoding;
                 message.width = descriptor.m_size.m_width;
                 message.height = descriptor.m_size.m_height;
-                message.step = message.width * Internal::BitDepth.at(format);
-                message.data = std::vector<uint8_t>(result.m_dataBuffer->data(), result.m_dataBuffer->data() + result.m_dataBuffer->size());
-                message.header = header;
-                publisher->publish(message);
-            });
+                message.step = message.width * imageFormat.m_bytesPerPixel;
+            }
+
+            // Image data is copied once, into a buffer which is only allocated for the first frame
+            const auto& readbackData = *result.m_dataBuffer;
+            message.data.resize(readbackData.size());
+            memcpy(message.data.data(), readbackData.data(), readbackData.size());
+            message.header = header;
+            publisher->publish(message);
+            if (imagePublished)
+            {
+                imagePublished(header);
+            }
+        };
+    }
+
+    CameraSensor::ReadbackCallback CameraSensor::AddPointCloudPublishing(
+        ReadbackCallback depthCallback, const std_msgs::msg::Header& header) const
+    {
+        if (!m_pointCloud)
+        {
+            return depthCallback;
+        }
+        return [depthCallback = AZStd::move(depthCallback), header, pointCloud = m_pointCloud](
+                   const AZ::RPI::AttachmentReadback::ReadbackResult& result)
+        {
+            depthCallback(result);
+            pointCloud->Publish(result, header);
+        };
+    }
+
+    CameraSensor::ReadbackCallback CameraSensor::MakeFrameCallback(ImagePublisherPtrType publisher, const std_msgs::msg::Header& header)
+    {
+        if (m_imageEncoder)
+        { // Readback data is shared with the encoder, which converts and publishes it off the render thread
+            return [header, imageEncoder = m_imageEncoder](const AZ::RPI::AttachmentReadback::ReadbackResult& result)
+            {
+                imageEncoder->QueueFrame(result, header);
+            };
+        }
+        return MakePublishingCallback(publisher, header, m_frameOutput, m_imagePublishedCallback);
+    }
+
+    bool CameraSensor::publishMassage(ImagePublisherPtrType publisher, const AZ::Transform& cameraPose, const std_msgs::msg::Header& header)
+    {
+        return RequestFrame(cameraPose, MakeFrameCallback(publisher, header));
     }
 
     CameraDepthSensor::CameraDepthSensor(const CameraSensorDescription& cameraSensorDescription)
@@ -211,6 +380,12 @@ namespace ROS2
         setupPasses();
     }
 
+    CameraSensor::ReadbackCallback CameraDepthSensor::MakeFrameCallback(
+        ImagePublisherPtrType publisher, const std_msgs::msg::Header& header)
+    {
+        return AddPointCloudPublishing(CameraSensor::MakeFrameCallback(publisher, header), header);
+    }
+
     AZStd::string CameraDepthSensor::getPipelineTemplateName()
     {
         return "PipelineRenderToTextureROSDepth";
@@ -237,4 +412,39 @@ namespace ROS2
         return "Color";
     };
 
+    CameraRGBDSensor::CameraRGBDSensor(const CameraSensorDescription& cameraSensorDescription, ImagePublisherPtrType depthPublisher)
+        : CameraSensor(cameraSensorDescription)
+        , m_depthPublisher(depthPublisher)
+        , m_depthFrameOutput(AZStd::make_shared<FrameOutput>())
+    {
+        setupPasses();
+    }
+
+    bool CameraRGBDSensor::publishMassage(
+        ImagePublisherPtrType publisher, const AZ::Transform& cameraPose, const std_msgs::msg::Header& header)
+    {
+        if (!CameraSensor::publishMassage(publisher, cameraPose, header))
+        {
+            return false;
+        }
+
+        // Linear depth is computed by the depth pre-pass of the color pipeline, the depth pipeline renders just that pass
+        const AZStd::vector<AZStd::string> depthPassHierarchy{ GetFramePipelineName(), "DepthPrePass" };
+        RequestAttachment(
+            depthPassHierarchy,
+            AZStd::string("DepthLinear"),
+            AddPointCloudPublishing(MakePublishingCallback(m_depthPublisher, header, m_depthFrameOutput, {}), header));
+        return true;
+    }
+
+    AZStd::string CameraRGBDSensor::getPipelineTemplateName()
+    {
+        return "PipelineRenderToTextureROSColor";
+    };
+
+    AZStd::string CameraRGBDSensor::getPipelineTypeName()
+    {
+        return "ColorDepth";
+    };
+
 } // namespace ROS2
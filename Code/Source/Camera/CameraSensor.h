@@ -7,8 +7,14 @@
  */
 #pragma once
 
+#include "CameraImageEncoder.h"
+#include "CameraPipeline.h"
+#include "CameraPointCloud.h"
 #include "ROS2/ROS2GemUtilities.h"
 #include <Atom/Feature/Utils/FrameCaptureBus.h>
+#include <AzCore/std/chrono/chrono.h>
+#include <AzCore/std/parallel/atomic.h>
+#include <AzCore/std/smart_ptr/shared_ptr.h>
 #include <chrono>
 #include <rclcpp/publisher.hpp>
 #include <sensor_msgs/msg/image.hpp>
@@ -27,18 +33,24 @@ namespace ROS2
         //! @param verticalFov - vertical field of view of camera sensor
         //! @param width - camera image width in pixels
         //! @param height - camera image height in pixels
-        CameraSensorDescription(const AZStd::string& cameraName, float verticalFov, int width, int height);
+        //! @param useSharedPipeline - render through pipelines shared with other cameras of the same resolution
+        CameraSensorDescription(
+            const AZStd::string& cameraName, float verticalFov, int width, int height, bool useSharedPipeline = false);
 
         const float m_verticalFieldOfViewDeg; //!< camera vertical field of view
         double m_verticalFieldOfViewRad;
         const int m_width; //!< camera image width in pixels
         const int m_height; //!< camera image height in pixels
         const AZStd::string m_cameraName; //!< camera name to differentiate cameras in a multi-camera setup
+        const bool m_useSharedPipeline; //!< whether the camera renders through a CameraPipelinePool instead of its own pipeline
 
         const float m_aspectRatio; //!< camera image aspect ratio; equal to (width / height)
         const AZ::Matrix4x4 m_viewToClipMatrix; //!< camera view to clip space transform matrix; derived from other parameters
         const AZStd::array<double, 9> m_cameraIntrinsics; //!< camera intrinsics; derived from other parameters
 
+        static constexpr float NearClipDistance = 0.1f; //!< camera near clip plane distance [m]
+        static constexpr float FarClipDistance = 100.0f; //!< camera far clip plane distance [m], depth of pixels with no surface
+
     private:
         AZ::Matrix4x4 MakeViewToClipMatrix() const;
 
@@ -47,11 +59,28 @@ namespace ROS2
         void validateParameters() const;
     };
 
+    //! Statistics of frame captures of a camera sensor.
+    struct CameraCaptureStatistics
+    {
+        size_t m_requestedFrameCount = 0;
+        //! Due frames which were not requested, such as when the maximum number of captures was in flight.
+        //! Frames which wait for a shared pipeline are counted once, when they are given up.
+        size_t m_skippedFrameCount = 0;
+        size_t m_completedFrameCount = 0;
+        size_t m_inFlightFrameCount = 0;
+        float m_averageLatencyMs = 0.0f; //!< Time from the request of a frame to its publishing.
+        float m_maxLatencyMs = 0.0f;
+    };
+
     //! Class to create camera sensor using Atom renderer
-    //! It creates dedicated rendering pipeline for each camera
+    //! It creates dedicated rendering pipeline for each camera, unless the camera shares pipelines with others
     class CameraSensor
     {
     public:
+        using ImagePublisherPtrType = std::shared_ptr<rclcpp::Publisher<sensor_msgs::msg::Image>>;
+        using ReadbackCallback = AZStd::function<void(const AZ::RPI::AttachmentReadback::ReadbackResult& result)>;
+        using ImagePublishedCallback = CameraImageEncoder::ImagePublishedCallback;
+
         //! Initializes rendering pipeline for the camera sensor
         //! @param cameraSensorDescription - camera sensor description used to create camera pipeline
         CameraSensor(const CameraSensorDescription& cameraSensorDescription);
@@ -60,30 +89,109 @@ namespace ROS2
         virtual ~CameraSensor();
 
         //! Function publish Image Message frame from rendering pipeline
-        //! @param publisher - ROS2 publisher to publish image in future
-        //! @param header - header with filled message information (frame, timestamp, seq)
+        //! @param publisher - ROS2 publisher to publish image in future, unused if the sensor has an image encoder
+        //! @param header - header with filled message information (frame, timestamp, seq), it should be sampled with the pose
         //! @param cameraPose - current camera pose from which the rendering should take place
-        void publishMassage(
-            std::shared_ptr<rclcpp::Publisher<sensor_msgs::msg::Image>> publisher,
-            const AZ::Transform& cameraPose,
-            const std_msgs::msg::Header& header);
+        //! @return false if no frame was requested, such as when too many captures are in flight or shared pipelines are taken
+        //! @see IsWaitingForPipeline
+        virtual bool publishMassage(ImagePublisherPtrType publisher, const AZ::Transform& cameraPose, const std_msgs::msg::Header& header);
+
+        //! Set an encoder which frames are passed to instead of being published as rendered.
+        //! The encoder publishes encoded frames with its own publishers.
+        void SetImageEncoder(AZStd::shared_ptr<CameraImageEncoder> imageEncoder);
+
+        //! Set a function called with the header of each image after it is published, such as to publish matching camera info.
+        //! It is called from the readback callback, or from the encoding job if the sensor has an encoder, so set the encoder first.
+        void SetImagePublishedCallback(ImagePublishedCallback imagePublishedCallback);
+
+        //! Set the maximum number of frames requested and not yet read back. Further frames are skipped until captures complete,
+        //! so that a renderer which falls behind does not accumulate readbacks and latency.
+        void SetMaxCapturesInFlight(AZ::u32 maxCapturesInFlight);
+
+        //! Publish organized point clouds reprojected from depth images, along with them. Used by sensors which read back depth.
+        void SetPointCloudPublisher(CameraPointCloud::PointCloudPublisherPtrType pointCloudPublisher);
+
+        //! Whether the last frame was not requested only since shared pipelines were taken, and should be requested again in
+        //! the next render frame. The sensor keeps its place among cameras waiting for the pipelines until it is requested.
+        [[nodiscard]] bool IsWaitingForPipeline() const;
+
+        //! Give up the frame the sensor is waiting for a pipeline for, counting it as skipped. Does nothing if it is not waiting.
+        //! @param keepWaiting - keep the place among waiting cameras, for a frame due in place of the skipped one
+        void SkipWaitingFrame(bool keepWaiting);
+
+        //! Statistics of frame captures since the sensor was created, which can be read while it captures frames.
+        [[nodiscard]] CameraCaptureStatistics GetCaptureStatistics() const;
 
         //! Function to get camera sensor description
         [[nodiscard]] const CameraSensorDescription& GetCameraSensorDescription() const;
 
+    protected:
+        //! Image message reused between frames, with metadata of the pipeline output.
+        //! It is shared with readback callbacks, which can be called after the sensor is destroyed.
+        struct FrameOutput
+        {
+            sensor_msgs::msg::Image m_message;
+            AZ::RHI::Format m_format = AZ::RHI::Format::Unknown; //!< Format which the message metadata was resolved for.
+        };
+
+        //! Read back an attachment of the frame requested with the last RequestFrame call, rendered in the same pipeline tick.
+        //! @param passHierarchy - names of the pass and its ancestors, starting with GetFramePipelineName()
+        //! @param slotName - slot of the pass which the attachment is bound to
+        //! @param callback - callback function object that will be called when capture is ready
+        //! @return false if the capture could not be requested
+        bool RequestAttachment(const AZStd::vector<AZStd::string>& passHierarchy, const AZStd::string& slotName, ReadbackCallback callback);
+
+        //! Make a readback callback which publishes images as they are, reusing the message of a frame output.
+        //! @param imagePublished - called after the image is published, can be empty
+        static ReadbackCallback MakePublishingCallback(
+            ImagePublisherPtrType publisher,
+            const std_msgs::msg::Header& header,
+            AZStd::shared_ptr<FrameOutput> frameOutput,
+            ImagePublishedCallback imagePublished);
+
+        //! Name of the pipeline which renders the frame requested with the last RequestFrame call.
+        const AZStd::string& GetFramePipelineName() const;
+
+        //! Make the callback of the main attachment of a frame, which publishes images as rendered or passes them to the encoder.
+        virtual ReadbackCallback MakeFrameCallback(ImagePublisherPtrType publisher, const std_msgs::msg::Header& header);
+
+        //! Extend a depth readback callback to also publish a point cloud, if the sensor has a point cloud publisher.
+        ReadbackCallback AddPointCloudPublishing(ReadbackCallback depthCallback, const std_msgs::msg::Header& header) const;
+
     private:
         //! Function requesting frame from rendering pipeline
         //! @param cameraPose - current camera pose from which the rendering should take place
         //! @param callback - callback function object that will be called when capture is ready
         //!                   it's argument is readback structure containing, among other thins, captured image
-        void RequestFrame(
-            const AZ::Transform& cameraPose, AZStd::function<void(const AZ::RPI::AttachmentReadback::ReadbackResult& result)> callback);
+        //! @return false if no frame was requested
+        bool RequestFrame(const AZ::Transform& cameraPose, ReadbackCallback callback);
+
+        //! Captures in flight and their latency. Shared with readback callbacks, which can be called after the sensor is destroyed.
+        //! Frames are tracked by their main attachment; other attachments of a frame are read back in the same pipeline tick.
+        struct CaptureTracker
+        {
+            //! Called after the main attachment of a frame was read back and published.
+            void CompleteFrame(AZStd::chrono::steady_clock::time_point requestTime);
+
+            AZStd::atomic<AZ::u32> m_inFlightFrameCount{ 0 };
+            AZStd::atomic<AZ::u64> m_completedFrameCount{ 0 };
+            AZStd::atomic<AZ::u64> m_totalLatencyUs{ 0 };
+            AZStd::atomic<AZ::u64> m_maxLatencyUs{ 0 };
+        };
 
         CameraSensorDescription m_cameraSensorDescription;
-        AZStd::vector<AZStd::string> m_passHierarchy;
-        AZ::RPI::RenderPipelinePtr m_pipeline;
-        AZ::RPI::ViewPtr m_view;
-        AZ::RPI::Scene* m_scene = nullptr;
+        AZStd::shared_ptr<FrameOutput> m_frameOutput;
+        AZStd::shared_ptr<CameraImageEncoder> m_imageEncoder;
+        AZStd::shared_ptr<CameraPointCloud> m_pointCloud; //!< Shared with readback callbacks, like the frame output.
+        ImagePublishedCallback m_imagePublishedCallback;
+        AZStd::shared_ptr<CaptureTracker> m_captureTracker;
+        AZ::u32 m_maxCapturesInFlight = 2;
+        size_t m_requestedFrameCount = 0;
+        size_t m_skippedFrameCount = 0;
+        bool m_isWaitingForPipeline = false;
+        AZStd::unique_ptr<CameraPipeline> m_ownPipeline; //!< Pipeline of the camera, unless it uses shared pipelines.
+        AZStd::shared_ptr<CameraPipelinePool> m_pipelinePool;
+        CameraPipeline* m_framePipeline = nullptr; //!< Pipeline of the last requested frame.
         const AZ::Transform kAtomToRos{ AZ::Transform::CreateFromQuaternion(
             AZ::Quaternion::CreateFromMatrix3x3(AZ::Matrix3x3::CreateFromRows({ 1, 0, 0 }, { 0, -1, 0 }, { 0, 0, -1 }))) };
         virtual AZStd::string getPipelineTemplateName() = 0;
@@ -99,6 +207,9 @@ namespace ROS2
     public:
         CameraDepthSensor(const CameraSensorDescription& cameraSensorDescription);
 
+    protected:
+        ReadbackCallback MakeFrameCallback(ImagePublisherPtrType publisher, const std_msgs::msg::Header& header) override;
+
     private:
         virtual AZStd::string getPipelineTemplateName() override;
         virtual AZStd::string getPipelineTypeName() override;
@@ -114,4 +225,22 @@ namespace ROS2
         virtual AZStd::string getPipelineTypeName() override;
     };
 
+    //! Color camera which also reads back depth from its pipeline, instead of rendering depth in a separate pipeline.
+    //! Color and depth images are rendered in the same pipeline tick, so they are pixel-aligned and share timestamps.
+    class CameraRGBDSensor : public CameraSensor
+    {
+    public:
+        //! @param depthPublisher - ROS2 publisher of depth images; color images are published like those of CameraColorSensor
+        CameraRGBDSensor(const CameraSensorDescription& cameraSensorDescription, ImagePublisherPtrType depthPublisher);
+
+        bool publishMassage(ImagePublisherPtrType publisher, const AZ::Transform& cameraPose, const std_msgs::msg::Header& header) override;
+
+    private:
+        virtual AZStd::string getPipelineTemplateName() override;
+        virtual AZStd::string getPipelineTypeName() override;
+
+        ImagePublisherPtrType m_depthPublisher;
+        AZStd::shared_ptr<FrameOutput> m_depthFrameOutput;
+    };
+
 } // namespace ROS2
@@ -12,6 +12,8 @@
 #include "ROS2/ROS2Bus.h"
 #include "ROS2/Utilities/ROS2Names.h"
 
+#include <Atom/RPI.Public/RPISystemInterface.h>
+#include <Atom/RPI.Public/Scene.h>
 #include <AzCore/Component/Entity.h>
 #include <AzCore/Component/TransformBus.h>
 #include <AzCore/Serialization/EditContext.h>
@@ -24,8 +26,12 @@ namespace ROS2
     namespace Internal
     {
         const char* kImageMessageType = "sensor_msgs::msg::Image";
+        const char* kCompressedImageMessageType = "sensor_msgs::msg::CompressedImage";
         const char* kDepthImageConfig = "Depth Image";
         const char* kColorImageConfig = "Color Image";
+        const char* kCompressedColorImageConfig = "Compressed Color Image";
+        const char* kPointCloudMessageType = "sensor_msgs::msg::PointCloud2";
+        const char* kDepthPointCloudConfig = "Depth Point Cloud";
         const char* kInfoConfig = "Camera Info";
         const char* kCameraInfoMessageType = "sensor_msgs::msg::CameraInfo";
 
@@ -57,6 +63,10 @@ namespace ROS2
             Internal::MakeTopicConfigurationPair("camera_image_depth", Internal::kImageMessageType, Internal::kDepthImageConfig));
         m_sensorConfiguration.m_publishersConfigurations.insert(
             Internal::MakeTopicConfigurationPair("camera_info", Internal::kCameraInfoMessageType, Internal::kInfoConfig));
+        m_sensorConfiguration.m_publishersConfigurations.insert(Internal::MakeTopicConfigurationPair(
+            "camera_image_color/compressed", Internal::kCompressedImageMessageType, Internal::kCompressedColorImageConfig));
+        m_sensorConfiguration.m_publishersConfigurations.insert(
+            Internal::MakeTopicConfigurationPair("camera_points", Internal::kPointCloudMessageType, Internal::kDepthPointCloudConfig));
     }
 
     void ROS2CameraSensorComponent::Reflect(AZ::ReflectContext* context)
@@ -65,12 +75,20 @@ namespace ROS2
         if (serialize)
         {
             serialize->Class<ROS2CameraSensorComponent, ROS2SensorComponent>()
-                ->Version(3)
+                ->Version(9)
                 ->Field("VerticalFieldOfViewDeg", &ROS2CameraSensorComponent::m_VerticalFieldOfViewDeg)
                 ->Field("Width", &ROS2CameraSensorComponent::m_width)
                 ->Field("Height", &ROS2CameraSensorComponent::m_height)
                 ->Field("Depth", &ROS2CameraSensorComponent::m_depthCamera)
-                ->Field("Color", &ROS2CameraSensorComponent::m_colorCamera);
+                ->Field("Color", &ROS2CameraSensorComponent::m_colorCamera)
+                ->Field("SharedColorDepthPipeline", &ROS2CameraSensorComponent::m_sharedColorDepthPipeline)
+                ->Field("ShareRenderPipeline", &ROS2CameraSensorComponent::m_shareRenderPipeline)
+                ->Field("ColorEncoding", &ROS2CameraSensorComponent::m_colorEncoding)
+                ->Field("ColorCompression", &ROS2CameraSensorComponent::m_colorCompression)
+                ->Field("EncodingQueueDepth", &ROS2CameraSensorComponent::m_encodingQueueDepth)
+                ->Field("MaxCapturesInFlight", &ROS2CameraSensorComponent::m_maxCapturesInFlight)
+                ->Field("DepthPointCloud", &ROS2CameraSensorComponent::m_depthPointCloud)
+                ->Field("PublishCameraInfoWithImage", &ROS2CameraSensorComponent::m_publishCameraInfoWithImage);
 
             AZ::EditContext* ec = serialize->GetEditContext();
             if (ec)
@@ -87,7 +105,56 @@ namespace ROS2
                     ->DataElement(AZ::Edit::UIHandlers::Default, &ROS2CameraSensorComponent::m_width, "Image width", "Image width")
                     ->DataElement(AZ::Edit::UIHandlers::Default, &ROS2CameraSensorComponent::m_height, "Image height", "Image height")
                     ->DataElement(AZ::Edit::UIHandlers::Default, &ROS2CameraSensorComponent::m_colorCamera, "Color Camera", "Color Camera")
-                    ->DataElement(AZ::Edit::UIHandlers::Default, &ROS2CameraSensorComponent::m_depthCamera, "Depth Camera", "Depth Camera");
+                    ->DataElement(AZ::Edit::UIHandlers::Default, &ROS2CameraSensorComponent::m_depthCamera, "Depth Camera", "Depth Camera")
+                    ->DataElement(
+                        AZ::Edit::UIHandlers::Default,
+                        &ROS2CameraSensorComponent::m_sharedColorDepthPipeline,
+                        "Shared color and depth pipeline",
+                        "Read depth back from the color pipeline, so that the scene is rendered once for both images")
+                    ->DataElement(
+                        AZ::Edit::UIHandlers::Default,
+                        &ROS2CameraSensorComponent::m_shareRenderPipeline,
+                        "Share render pipeline",
+                        "Render through pipelines shared with other cameras of the same resolution, one camera per pipeline "
+                        "and frame. Saves memory and setup of many low-rate cameras; frames can be delayed while pipelines are taken")
+                    ->DataElement(
+                        AZ::Edit::UIHandlers::ComboBox,
+                        &ROS2CameraSensorComponent::m_colorEncoding,
+                        "Color encoding",
+                        "Encoding of color images. Dropping the alpha channel saves a quarter of the bandwidth")
+                    ->EnumAttribute(CameraImageEncoder::Encoding::Rgba8, "rgba8")
+                    ->EnumAttribute(CameraImageEncoder::Encoding::Rgb8, "rgb8")
+                    ->EnumAttribute(CameraImageEncoder::Encoding::Bgr8, "bgr8")
+                    ->DataElement(
+                        AZ::Edit::UIHandlers::ComboBox,
+                        &ROS2CameraSensorComponent::m_colorCompression,
+                        "Color compression",
+                        "Additionally publish compressed color images, on the compressed color image topic")
+                    ->EnumAttribute(CameraImageEncoder::Compression::None, "None")
+                    ->EnumAttribute(CameraImageEncoder::Compression::Png, "PNG")
+                    ->DataElement(
+                        AZ::Edit::UIHandlers::Default,
+                        &ROS2CameraSensorComponent::m_encodingQueueDepth,
+                        "Encoding queue depth",
+                        "Maximum number of color images waiting for encoding. When exceeded, the oldest image is dropped")
+                    ->Attribute(AZ::Edit::Attributes::Min, 1)
+                    ->DataElement(
+                        AZ::Edit::UIHandlers::Default,
+                        &ROS2CameraSensorComponent::m_maxCapturesInFlight,
+                        "Max captures in flight",
+                        "Maximum number of frames rendered and not yet read back. Frames due above this limit are skipped, "
+                        "not delayed")
+                    ->Attribute(AZ::Edit::Attributes::Min, 1)
+                    ->DataElement(
+                        AZ::Edit::UIHandlers::Default,
+                        &ROS2CameraSensorComponent::m_depthPointCloud,
+                        "Depth point cloud",
+                        "Publish an organized point cloud reprojected from each depth image, on the depth point cloud topic")
+                    ->DataElement(
+                        AZ::Edit::UIHandlers::Default,
+                        &ROS2CameraSensorComponent::m_publishCameraInfoWithImage,
+                        "Camera info with images",
+                        "Publish camera info when an image is published, with the same header, instead of on each frame request");
             }
         }
     }
@@ -96,7 +163,7 @@ namespace ROS2
     {
         ROS2SensorComponent::Activate();
 
-        auto ros2Node = ROS2Interface::Get()->GetNode();
+        auto ros2Node = GetNamespaceNode();
 
         const auto cameraInfoPublisherConfig = m_sensorConfiguration.m_publishersConfigurations[Internal::kInfoConfig];
         AZStd::string cameraInfoFullTopic = ROS2Names::GetNamespacedName(GetNamespace(), cameraInfoPublisherConfig.m_topic);
@@ -106,60 +173,192 @@ namespace ROS2
             ros2Node->create_publisher<sensor_msgs::msg::CameraInfo>(cameraInfoFullTopic.data(), cameraInfoPublisherConfig.GetQoS());
 
         const CameraSensorDescription description{
-            Internal::GetCameraNameFromFrame(GetEntity()), m_VerticalFieldOfViewDeg, m_width, m_height
+            Internal::GetCameraNameFromFrame(GetEntity()), m_VerticalFieldOfViewDeg, m_width, m_height, m_shareRenderPipeline
         };
-        if (m_colorCamera)
+        ImagePublisherPtrType depthPublisher;
+        if (m_depthCamera)
         {
-            const auto cameraImagePublisherConfig = m_sensorConfiguration.m_publishersConfigurations[Internal::kColorImageConfig];
+            const auto cameraImagePublisherConfig = m_sensorConfiguration.m_publishersConfigurations[Internal::kDepthImageConfig];
             AZStd::string cameraImageFullTopic = ROS2Names::GetNamespacedName(GetNamespace(), cameraImagePublisherConfig.m_topic);
-            auto publisher =
+            depthPublisher =
                 ros2Node->create_publisher<sensor_msgs::msg::Image>(cameraImageFullTopic.data(), cameraImagePublisherConfig.GetQoS());
-            m_cameraSensorsWithPublihsers.emplace_back(createPair<CameraColorSensor>(publisher, description));
         }
-        if (m_depthCamera)
+        const bool useSharedPipeline = m_colorCamera && m_depthCamera && m_sharedColorDepthPipeline;
+        if (m_colorCamera)
         {
-            const auto cameraImagePublisherConfig = m_sensorConfiguration.m_publishersConfigurations[Internal::kDepthImageConfig];
+            const auto cameraImagePublisherConfig = m_sensorConfiguration.m_publishersConfigurations[Internal::kColorImageConfig];
             AZStd::string cameraImageFullTopic = ROS2Names::GetNamespacedName(GetNamespace(), cameraImagePublisherConfig.m_topic);
             auto publisher =
                 ros2Node->create_publisher<sensor_msgs::msg::Image>(cameraImageFullTopic.data(), cameraImagePublisherConfig.GetQoS());
-            m_cameraSensorsWithPublihsers.emplace_back(createPair<CameraDepthSensor>(publisher, description));
+
+            CameraImageEncoder::CompressedImagePublisherPtrType compressedPublisher;
+            if (m_colorCompression != CameraImageEncoder::Compression::None)
+            { // Components saved before compression was added do not have its topic configured
+                m_sensorConfiguration.m_publishersConfigurations.insert(Internal::MakeTopicConfigurationPair(
+                    "camera_image_color/compressed", Internal::kCompressedImageMessageType, Internal::kCompressedColorImageConfig));
+                const auto compressedPublisherConfig =
+                    m_sensorConfiguration.m_publishersConfigurations[Internal::kCompressedColorImageConfig];
+                AZStd::string compressedFullTopic = ROS2Names::GetNamespacedName(GetNamespace(), compressedPublisherConfig.m_topic);
+                compressedPublisher = ros2Node->create_publisher<sensor_msgs::msg::CompressedImage>(
+                    compressedFullTopic.data(), compressedPublisherConfig.GetQoS());
+            }
+
+            const CameraImageEncoder::Configuration encoderConfiguration{ m_colorEncoding, m_colorCompression, m_encodingQueueDepth };
+            m_colorImageEncoder = AZStd::make_shared<CameraImageEncoder>(encoderConfiguration, publisher, compressedPublisher);
+            auto colorSensorPair = useSharedPipeline
+                ? PublisherSensorPtrPair{ publisher, AZStd::make_shared<CameraRGBDSensor>(description, depthPublisher) }
+                : createPair<CameraColorSensor>(publisher, description);
+            colorSensorPair.second->SetImageEncoder(m_colorImageEncoder);
+            m_cameraSensorsWithPublihsers.emplace_back(AZStd::move(colorSensorPair));
+        }
+        if (m_depthCamera && !useSharedPipeline)
+        {
+            m_cameraSensorsWithPublihsers.emplace_back(createPair<CameraDepthSensor>(depthPublisher, description));
+        }
+        if (m_depthCamera && m_depthPointCloud)
+        { // Components saved before point clouds were added do not have their topic configured
+            m_sensorConfiguration.m_publishersConfigurations.insert(Internal::MakeTopicConfigurationPair(
+                "camera_points", Internal::kPointCloudMessageType, Internal::kDepthPointCloudConfig));
+            const auto pointCloudPublisherConfig = m_sensorConfiguration.m_publishersConfigurations[Internal::kDepthPointCloudConfig];
+            AZStd::string pointCloudFullTopic = ROS2Names::GetNamespacedName(GetNamespace(), pointCloudPublisherConfig.m_topic);
+            auto pointCloudPublisher = ros2Node->create_publisher<sensor_msgs::msg::PointCloud2>(
+                pointCloudFullTopic.data(), pointCloudPublisherConfig.GetQoS());
+            // Depth is read back by the last sensor, which is either the depth sensor or the one with the shared pipeline
+            m_cameraSensorsWithPublihsers.back().second->SetPointCloudPublisher(pointCloudPublisher);
+        }
+        for (auto& [publisher, sensor] : m_cameraSensorsWithPublihsers)
+        {
+            sensor->SetMaxCapturesInFlight(m_maxCapturesInFlight);
         }
         const auto* component = Utils::GetGameOrEditorComponent<ROS2FrameComponent>(GetEntity());
         AZ_Assert(component, "Entity has no ROS2FrameComponent");
         m_frameName = component->GetFrameID();
+
+        if (m_publishCameraInfoWithImage && !m_cameraSensorsWithPublihsers.empty())
+        { // Images of other sensors are rendered in the same frame, one camera info describes all of them
+            m_cameraSensorsWithPublihsers.front().second->SetImagePublishedCallback(
+                [cameraInfoPublisher = m_cameraInfoPublisher, cameraInfo = MakeCameraInfo()](const std_msgs::msg::Header& header)
+                {
+                    sensor_msgs::msg::CameraInfo message = cameraInfo;
+                    message.header = header;
+                    cameraInfoPublisher->publish(message);
+                });
+        }
+
+        m_isFrameDue = false;
+        if (auto* scene = AZ::RPI::RPISystemInterface::Get()->GetSceneByName(AZ::Name("Main")))
+        {
+            AZ::RPI::SceneNotificationBus::Handler::BusConnect(scene->GetId());
+        }
     }
 
     void ROS2CameraSensorComponent::Deactivate()
     {
+        AZ::RPI::SceneNotificationBus::Handler::BusDisconnect();
+        for (const auto& [cameraName, statistics] : GetCaptureStatistics())
+        {
+            AZ_TracePrintf(
+                "ROS2 Camera Sensor Component",
+                "Camera %s captured %zu frames, skipped %zu with %u captures in flight, latency average %.1f ms, max %.1f ms\n",
+                cameraName.c_str(),
+                statistics.m_completedFrameCount,
+                statistics.m_skippedFrameCount,
+                m_maxCapturesInFlight,
+                statistics.m_averageLatencyMs,
+                statistics.m_maxLatencyMs);
+        }
         m_cameraSensorsWithPublihsers.clear();
+        if (m_colorImageEncoder)
+        { // Frames in the queue finish encoding in jobs, which keep the encoder alive
+            const auto statistics = m_colorImageEncoder->GetStatistics();
+            AZ_TracePrintf(
+                "ROS2 Camera Sensor Component",
+                "Encoded %zu color images, dropped %zu while the encoder was busy\n",
+                statistics.m_encodedFrameCount,
+                statistics.m_droppedFrameCount);
+            m_colorImageEncoder.reset();
+        }
         ROS2SensorComponent::Deactivate();
     }
 
+    AZStd::vector<AZStd::pair<AZStd::string, CameraCaptureStatistics>> ROS2CameraSensorComponent::GetCaptureStatistics() const
+    {
+        AZStd::vector<AZStd::pair<AZStd::string, CameraCaptureStatistics>> statistics;
+        statistics.reserve(m_cameraSensorsWithPublihsers.size());
+        for (const auto& [publisher, sensor] : m_cameraSensorsWithPublihsers)
+        {
+            statistics.emplace_back(sensor->GetCameraSensorDescription().m_cameraName, sensor->GetCaptureStatistics());
+        }
+        return statistics;
+    }
+
+    sensor_msgs::msg::CameraInfo ROS2CameraSensorComponent::MakeCameraInfo() const
+    {
+        const auto& camera_descritpion = m_cameraSensorsWithPublihsers.front().second->GetCameraSensorDescription();
+        const auto& cameraIntrinsics = camera_descritpion.m_cameraIntrinsics;
+        sensor_msgs::msg::CameraInfo cameraInfo;
+        cameraInfo.width = m_width;
+        cameraInfo.height = m_height;
+        cameraInfo.distortion_model = sensor_msgs::distortion_models::PLUMB_BOB;
+        AZ_Assert(cameraIntrinsics.size() == cameraInfo.k.size(), "should be 9");
+        std::copy_n(cameraIntrinsics.data(), cameraIntrinsics.size(), cameraInfo.k.begin());
+        cameraInfo.p = { cameraInfo.k[0], cameraInfo.k[1], cameraInfo.k[2], 0, cameraInfo.k[3], cameraInfo.k[4], cameraInfo.k[5], 0,
+                         cameraInfo.k[6], cameraInfo.k[7], cameraInfo.k[8], 0 };
+        return cameraInfo;
+    }
+
     void ROS2CameraSensorComponent::FrequencyTick()
     {
-        const AZ::Transform transform = GetEntity()->GetTransform()->GetWorldTM();
-        const auto timestamp = ROS2Interface::Get()->GetROSTimestamp();
+        if (m_isFrameDue)
+        { // The previous frame still waits for shared pipelines, this one is requested in its place
+            for (const auto& [publisher, sensor] : m_cameraSensorsWithPublihsers)
+            {
+                sensor->SkipWaitingFrame(true);
+            }
+        }
+        m_isFrameDue = true;
+        m_frameTransform = GetEntity()->GetTransform()->GetWorldTM();
+        m_frameStamp = GetSampleTimestamp();
+    }
+
+    void ROS2CameraSensorComponent::OnBeginPrepareRender()
+    {
+        if (!m_isFrameDue || m_cameraSensorsWithPublihsers.empty())
+        {
+            return;
+        }
+
+        // Pose and time of the view, sampled on the physics substep the frame is due after. Readbacks carry them to publishing.
+        const AZ::Transform& transform = m_frameTransform;
         std_msgs::msg::Header ros_header;
-        if (!m_cameraSensorsWithPublihsers.empty())
+        ros_header.stamp = m_frameStamp;
+        ros_header.frame_id = m_frameName.c_str();
+        bool isRequested = false;
+        bool isWaiting = false;
+        for (auto& [publisher, sensor] : m_cameraSensorsWithPublihsers)
         {
-            const auto& camera_descritpion = m_cameraSensorsWithPublihsers.front().second->GetCameraSensorDescription();
-            const auto& cameraIntrinsics = camera_descritpion.m_cameraIntrinsics;
-            sensor_msgs::msg::CameraInfo cameraInfo;
-            ros_header.stamp = timestamp;
-            ros_header.frame_id = m_frameName.c_str();
-            cameraInfo.header = ros_header;
-            cameraInfo.width = m_width;
-            cameraInfo.height = m_height;
-            cameraInfo.distortion_model = sensor_msgs::distortion_models::PLUMB_BOB;
-            AZ_Assert(cameraIntrinsics.size() == cameraInfo.k.size(), "should be 9");
-            std::copy_n(cameraIntrinsics.data(), cameraIntrinsics.size(), cameraInfo.k.begin());
-            cameraInfo.p = { cameraInfo.k[0], cameraInfo.k[1], cameraInfo.k[2], 0, cameraInfo.k[3], cameraInfo.k[4], cameraInfo.k[5], 0,
-                             cameraInfo.k[6], cameraInfo.k[7], cameraInfo.k[8], 0 };
-            m_cameraInfoPublisher->publish(cameraInfo);
+            isRequested |= sensor->publishMassage(publisher, transform, ros_header);
+            isWaiting |= sensor->IsWaitingForPipeline();
         }
+        if (isWaiting && !isRequested)
+        { // Shared pipelines are taken by other cameras, the frame is requested again in the next one
+            return;
+        }
+        m_isFrameDue = false;
         for (auto& [publisher, sensor] : m_cameraSensorsWithPublihsers)
+        { // Sensors still waiting for shared pipelines give up this frame, it is not requested again for the others
+            sensor->SkipWaitingFrame(false);
+        }
+        if (!isRequested)
+        { // Skipped, such as when the maximum number of captures is in flight
+            return;
+        }
+
+        if (!m_publishCameraInfoWithImage)
         {
-            sensor->publishMassage(publisher, transform, ros_header);
+            sensor_msgs::msg::CameraInfo cameraInfo = MakeCameraInfo();
+            cameraInfo.header = ros_header;
+            m_cameraInfoPublisher->publish(cameraInfo);
         }
     }
 } // namespace ROS2
@@ -13,6 +13,7 @@
 
 #include "ROS2/Sensor/ROS2SensorComponent.h"
 
+#include <Atom/RPI.Public/SceneBus.h>
 #include <AzCore/Component/Component.h>
 
 #include <ROS2/Frame/NamespaceConfiguration.h>
@@ -28,8 +29,14 @@ namespace ROS2
     //!   - camera name
     //!   - camera image width and height in pixels
     //!   - camera vertical field of view in degrees
+    //!   - encoding and compression of color images, which are done by CameraImageEncoder in jobs
+    //!   - organized point clouds reprojected from depth images by CameraPointCloud
     //! Camera frustum is facing negative Z axis; image plane is parallel to X,Y plane: X - right, Y - up
-    class ROS2CameraSensorComponent : public ROS2SensorComponent
+    //! Frames due in a sensor tick are requested when the scene is prepared for rendering, with the pose and the timestamp
+    //! of the sample, so that published images are stamped with the time of the view they were rendered from.
+    class ROS2CameraSensorComponent
+        : public ROS2SensorComponent
+        , public AZ::RPI::SceneNotificationBus::Handler
     {
     public:
         ROS2CameraSensorComponent();
@@ -40,6 +47,10 @@ namespace ROS2
         void Activate() override;
         void Deactivate() override;
 
+        //! Capture statistics of the camera sensors of the component, such as to monitor rendering while simulating.
+        //! @return Statistics by camera name, the color sensor first; empty when the component is not active.
+        AZStd::vector<AZStd::pair<AZStd::string, CameraCaptureStatistics>> GetCaptureStatistics() const;
+
     private:
         //! Type aliases for pointer used in this component
         using ImagePublisherPtrType = std::shared_ptr<rclcpp::Publisher<sensor_msgs::msg::Image>>;
@@ -58,10 +69,31 @@ namespace ROS2
         int m_height = 480;
         bool m_colorCamera = true;
         bool m_depthCamera = true;
+        bool m_sharedColorDepthPipeline = true; //!< Render color and depth in one pipeline when both are enabled.
+        bool m_shareRenderPipeline = false; //!< Render through a CameraPipelinePool shared with other cameras.
+        CameraImageEncoder::Encoding m_colorEncoding = CameraImageEncoder::Encoding::Rgba8;
+        CameraImageEncoder::Compression m_colorCompression = CameraImageEncoder::Compression::None;
+        unsigned int m_encodingQueueDepth = 2;
+        unsigned int m_maxCapturesInFlight = 2;
+        bool m_depthPointCloud = false; //!< Publish point clouds reprojected from depth images by CameraPointCloud.
+        bool m_publishCameraInfoWithImage = true; //!< Publish camera info when an image is published, with its header.
+        bool m_isFrameDue = false; //!< Set in the sensor tick, frames are requested on render preparation.
+        AZ::Transform m_frameTransform = AZ::Transform::CreateIdentity(); //!< Camera pose of the frame due.
+        builtin_interfaces::msg::Time m_frameStamp; //!< Sample timestamp of the frame due.
 
         void FrequencyTick() override;
+
+        ////////////////////////////////////////////////////////////////////////
+        // AZ::RPI::SceneNotificationBus::Handler interface implementation
+        void OnBeginPrepareRender() override;
+        ////////////////////////////////////////////////////////////////////////
+
+        //! Camera info of the first sensor, without header.
+        sensor_msgs::msg::CameraInfo MakeCameraInfo() const;
+
         AZStd::vector<PublisherSensorPtrPair> m_cameraSensorsWithPublihsers;
         CameraInfoPublisherPtrType m_cameraInfoPublisher;
+        AZStd::shared_ptr<CameraImageEncoder> m_colorImageEncoder;
 
         AZStd::string m_frameName;
     };
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project.
+ * For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#include "MainThreadCallbackQueue.h"
+
+namespace ROS2
+{
+    MainThreadCallbackQueue::~MainThreadCallbackQueue()
+    {
+        Node* node = m_newest.exchange(nullptr);
+        while (node)
+        {
+            Node* next = node->m_next;
+            delete node;
+            node = next;
+        }
+    }
+
+    void MainThreadCallbackQueue::Push(Callback callback)
+    {
+        Node* node = new Node{ AZStd::move(callback), m_newest.load(AZStd::memory_order_relaxed) };
+        while (!m_newest.compare_exchange_weak(node->m_next, node, AZStd::memory_order_release, AZStd::memory_order_relaxed))
+        {
+        }
+    }
+
+    size_t MainThreadCallbackQueue::RunAll()
+    {
+        // Taking all nodes at once leaves producers a list of their own, so no node is ever removed under them
+        Node* newest = m_newest.exchange(nullptr, AZStd::memory_order_acquire);
+        Node* oldest = nullptr;
+        while (newest)
+        {
+            Node* next = newest->m_next;
+            newest->m_next = oldest;
+            oldest = newest;
+            newest = next;
+        }
+
+        size_t count = 0;
+        while (oldest)
+        {
+            Node* next = oldest->m_next;
+            oldest->m_callback();
+            delete oldest;
+            oldest = next;
+            count++;
+        }
+        return count;
+    }
+} // namespace ROS2
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project.
+ * For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+#pragma once
+
+#include <AzCore/std/functional.h>
+#include <AzCore/std/parallel/atomic.h>
+
+namespace ROS2
+{
+    //! Queue of functions handed off from ROS 2 executor threads to the main thread.
+    //! Pushing is lock-free, so that executor threads never wait for the main thread, which runs all queued functions at once.
+    //! Functions pushed from one thread run in the order in which they were pushed.
+    class MainThreadCallbackQueue
+    {
+    public:
+        using Callback = AZStd::function<void()>;
+
+        MainThreadCallbackQueue() = default;
+        MainThreadCallbackQueue(const MainThreadCallbackQueue&) = delete;
+        MainThreadCallbackQueue& operator=(const MainThreadCallbackQueue&) = delete;
+
+        //! Functions which were not run are dropped.
+        ~MainThreadCallbackQueue();
+
+        //! Queue a function. It can be called from any thread.
+        void Push(Callback callback);
+
+        //! Run all queued functions, in the order of pushing. Call from one thread only.
+        //! Functions queued while running are left for the next call.
+        //! @return Number of functions run.
+        size_t RunAll();
+
+    private:
+        struct Node
+        {
+            Callback m_callback;
+            Node* m_next = nullptr;
+        };
+
+        //! Most recently pushed node. Nodes are linked from newest to oldest; RunAll takes the whole list and reverses it.
+        AZStd::atomic<Node*> m_newest{ nullptr };
+    };
+} // namespace ROS2
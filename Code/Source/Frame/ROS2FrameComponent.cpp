@@ -18,6 +18,10 @@ namespace ROS2
 {
     namespace Internal
     {
+        //! Version of frame hierarchies of all frames, incremented on any change which can affect them.
+        //! Frame hierarchies are only used from the main thread.
+        AZ::u64 frameHierarchyVersion = 1;
+
         AZ::TransformInterface* GetEntityTransformInterface(const AZ::Entity* entity)
         {
             // TODO - instead, use EditorFrameComponent to handle Editor-context queries and here only use the "Game" version
@@ -62,7 +66,11 @@ namespace ROS2
 
     void ROS2FrameComponent::Activate()
     {
-        m_namespaceConfiguration.PopulateNamespace(IsTopLevel(), GetEntity()->GetName());
+        m_namespaceConfiguration.PopulateNamespace(
+            Internal::GetFirstROS2FrameAncestor(GetEntity()) == nullptr, GetEntity()->GetName());
+        m_isActive = true;
+        InvalidateFrameHierarchies(); // Descendants activated before this frame resolved their namespaces without it
+        ConnectHierarchyNotifications();
 
         if (m_publishTransform)
         {
@@ -96,6 +104,9 @@ namespace ROS2
             }
             m_ros2Transform.reset();
         }
+        AZ::TransformNotificationBus::MultiHandler::BusDisconnect();
+        m_isActive = false;
+        InvalidateFrameHierarchies();
     }
 
     void ROS2FrameComponent::OnTick([[maybe_unused]] float deltaTime, [[maybe_unused]] AZ::ScriptTimePoint time)
@@ -103,10 +114,62 @@ namespace ROS2
         m_ros2Transform->Publish(GetFrameTransform());
     }
 
-    AZStd::string ROS2FrameComponent::GetGlobalFrameName() const
+    void ROS2FrameComponent::OnParentChanged([[maybe_unused]] AZ::EntityId oldParent, [[maybe_unused]] AZ::EntityId newParent)
+    {
+        InvalidateFrameHierarchies();
+        ConnectHierarchyNotifications(); // Entities between this frame and its parent frame can be different now
+    }
+
+    void ROS2FrameComponent::ConnectHierarchyNotifications()
+    {
+        AZ::TransformNotificationBus::MultiHandler::BusDisconnect();
+        AZ::TransformNotificationBus::MultiHandler::BusConnect(GetEntityId());
+        AZ::EntityId ancestorId;
+        AZ::TransformBus::EventResult(ancestorId, GetEntityId(), &AZ::TransformBus::Events::GetParentId);
+        while (ancestorId.IsValid())
+        {
+            AZ::Entity* ancestor = nullptr;
+            AZ::ComponentApplicationBus::BroadcastResult(ancestor, &AZ::ComponentApplicationRequests::FindEntity, ancestorId);
+            if (!ancestor || Utils::GetGameOrEditorComponent<ROS2FrameComponent>(ancestor))
+            { // Parent frame, which handles changes of its own hierarchy
+                break;
+            }
+            AZ::TransformNotificationBus::MultiHandler::BusConnect(ancestorId);
+            const AZ::EntityId childId = ancestorId;
+            ancestorId.SetInvalid();
+            AZ::TransformBus::EventResult(ancestorId, childId, &AZ::TransformBus::Events::GetParentId);
+        }
+    }
+
+    void ROS2FrameComponent::InvalidateFrameHierarchies()
     {
+        Internal::frameHierarchyVersion++;
+    }
+
+    const ROS2FrameComponent::FrameHierarchy& ROS2FrameComponent::GetFrameHierarchy() const
+    {
+        if (m_isActive && m_frameHierarchy.m_version == Internal::frameHierarchyVersion)
+        {
+            return m_frameHierarchy;
+        }
+
+        // Ancestors are resolved through their own caches, so a hierarchy is walked once per invalidation
+        FrameHierarchy& hierarchy = m_frameHierarchy;
+        hierarchy.m_parentFrame = Internal::GetFirstROS2FrameAncestor(GetEntity());
+        hierarchy.m_transformInterface = Internal::GetEntityTransformInterface(GetEntity());
+        hierarchy.m_namespace =
+            m_namespaceConfiguration.GetNamespace(hierarchy.m_parentFrame ? hierarchy.m_parentFrame->GetNamespace() : AZStd::string());
+        hierarchy.m_frameId = ROS2Names::GetNamespacedName(hierarchy.m_namespace, m_frameName);
         // TODO - parametrize this (typically: "odom", "world" and sometimes "map")
-        return ROS2Names::GetNamespacedName(GetNamespace(), AZStd::string("odom"));
+        hierarchy.m_globalFrameName = ROS2Names::GetNamespacedName(hierarchy.m_namespace, AZStd::string("odom"));
+        hierarchy.m_parentFrameId = hierarchy.m_parentFrame ? hierarchy.m_parentFrame->GetFrameID() : hierarchy.m_globalFrameName;
+        hierarchy.m_version = m_isActive ? Internal::frameHierarchyVersion : 0;
+        return hierarchy;
+    }
+
+    const AZStd::string& ROS2FrameComponent::GetGlobalFrameName() const
+    {
+        return GetFrameHierarchy().m_globalFrameName;
     }
 
     bool ROS2FrameComponent::IsTopLevel() const
@@ -121,47 +184,38 @@ namespace ROS2
 
     const ROS2FrameComponent* ROS2FrameComponent::GetParentROS2FrameComponent() const
     {
-        return Internal::GetFirstROS2FrameAncestor(GetEntity());
+        return GetFrameHierarchy().m_parentFrame;
     }
 
     const AZ::Transform& ROS2FrameComponent::GetFrameTransform() const
     {
-        auto* transformInterface = Internal::GetEntityTransformInterface(GetEntity());
-        if (GetParentROS2FrameComponent() != nullptr)
+        const FrameHierarchy& hierarchy = GetFrameHierarchy();
+        if (hierarchy.m_parentFrame != nullptr)
         {
-            return transformInterface->GetLocalTM();
+            return hierarchy.m_transformInterface->GetLocalTM();
         }
-        return transformInterface->GetWorldTM();
+        return hierarchy.m_transformInterface->GetWorldTM();
     }
 
-    AZStd::string ROS2FrameComponent::GetParentFrameID() const
+    const AZStd::string& ROS2FrameComponent::GetParentFrameID() const
     {
-        if (auto parentFrame = GetParentROS2FrameComponent(); parentFrame != nullptr)
-        {
-            return parentFrame->GetFrameID();
-        }
-        return GetGlobalFrameName();
+        return GetFrameHierarchy().m_parentFrameId;
     }
 
-    AZStd::string ROS2FrameComponent::GetFrameID() const
+    const AZStd::string& ROS2FrameComponent::GetFrameID() const
     {
-        return ROS2Names::GetNamespacedName(GetNamespace(), m_frameName);
+        return GetFrameHierarchy().m_frameId;
     }
 
     void ROS2FrameComponent::SetFrameID(const AZStd::string& frameId)
     {
         m_frameName = frameId;
+        InvalidateFrameHierarchies();
     }
 
-    AZStd::string ROS2FrameComponent::GetNamespace() const
+    const AZStd::string& ROS2FrameComponent::GetNamespace() const
     {
-        auto parentFrame = GetParentROS2FrameComponent();
-        AZStd::string parentNamespace("");
-        if (parentFrame != nullptr)
-        {
-            parentNamespace = parentFrame->GetNamespace();
-        }
-        return m_namespaceConfiguration.GetNamespace(parentNamespace);
+        return GetFrameHierarchy().m_namespace;
     }
 
     void ROS2FrameComponent::Reflect(AZ::ReflectContext* context)
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project.
+ * For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#include "TransformAggregator.h"
+#include <AzCore/Math/MathUtils.h>
+#include <AzCore/Settings/SettingsRegistry.h>
+
+namespace ROS2
+{
+    TransformAggregator::TransformAggregator(std::shared_ptr<rclcpp::Node> node)
+        : m_dynamicBroadcaster(node)
+        , m_staticBroadcaster(node)
+    {
+        double publishRate = 0.0;
+        if (auto* settingsRegistry = AZ::SettingsRegistry::Get())
+        {
+            settingsRegistry->Get(publishRate, PublishRateRegistryPath);
+        }
+        m_publishInterval = publishRate > 0.0 ? static_cast<float>(1.0 / publishRate) : 0.0f;
+        AZ::TickBus::Handler::BusConnect();
+    }
+
+    TransformAggregator::~TransformAggregator()
+    {
+        AZ::TickBus::Handler::BusDisconnect();
+    }
+
+    void TransformAggregator::AddTransform(const geometry_msgs::msg::TransformStamped& transform, bool isDynamic)
+    {
+        if (!isDynamic)
+        {
+            m_staticTransforms.push_back(transform);
+            return;
+        }
+
+        const AZStd::string childFrame(transform.child_frame_id.c_str());
+        if (auto found = m_dynamicTransformIndices.find(childFrame); found != m_dynamicTransformIndices.end())
+        { // Sent again before publishing, the latest transform replaces the previous one
+            m_dynamicTransforms[found->second] = transform;
+            return;
+        }
+        m_dynamicTransformIndices[childFrame] = m_dynamicTransforms.size();
+        m_dynamicTransforms.push_back(transform);
+    }
+
+    int TransformAggregator::GetTickOrder()
+    { // After all frames, so that transforms sent in this tick are published in it
+        return AZ::ComponentTickBus::TICK_LAST;
+    }
+
+    void TransformAggregator::OnTick(float deltaTime, [[maybe_unused]] AZ::ScriptTimePoint time)
+    {
+        if (!m_staticTransforms.empty())
+        { // The broadcaster merges them into its latched message, which it republishes whole
+            m_staticBroadcaster.sendTransform(m_staticTransforms);
+            m_staticTransforms.clear();
+        }
+
+        m_timeSincePublish += deltaTime;
+        if (m_dynamicTransforms.empty() || m_timeSincePublish < m_publishInterval)
+        {
+            return;
+        }
+        m_dynamicBroadcaster.sendTransform(m_dynamicTransforms);
+        m_dynamicTransforms.clear();
+        m_dynamicTransformIndices.clear();
+        // Time past the interval is carried over to keep the rate, but no more than an interval, so a hitch is not followed by a burst
+        m_timeSincePublish = AZ::GetClamp(m_timeSincePublish - m_publishInterval, 0.0f, m_publishInterval);
+    }
+} // namespace ROS2
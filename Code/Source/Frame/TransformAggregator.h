@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project.
+ * For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+#pragma once
+
+#include <AzCore/Component/TickBus.h>
+#include <AzCore/std/containers/unordered_map.h>
+#include <AzCore/std/string/string.h>
+#include <geometry_msgs/msg/transform_stamped.hpp>
+#include <rclcpp/node.hpp>
+#include <tf2_ros/static_transform_broadcaster.h>
+#include <tf2_ros/transform_broadcaster.h>
+#include <vector>
+
+namespace ROS2
+{
+    //! Collects transforms sent during a tick and publishes them at its end, all dynamic transforms in one /tf message
+    //! and new static transforms in one update of the latched /tf_static message.
+    //! Dynamic transforms can be published at a lower rate than the frame rate, read from the settings registry at
+    //! PublishRateRegistryPath in Hz; they are published in each tick if it is zero or not set. Of transforms of a child
+    //! frame sent between publishes, only the latest one is published.
+    //! @note Transforms are to be added from the main thread.
+    class TransformAggregator : public AZ::TickBus::Handler
+    {
+    public:
+        static constexpr const char* PublishRateRegistryPath = "/O3DE/ROS2/TF/PublishRate";
+
+        //! @param node - node of the tf broadcasters
+        explicit TransformAggregator(std::shared_ptr<rclcpp::Node> node);
+        ~TransformAggregator();
+
+        //! Add a transform to the message published at the end of the tick.
+        //! @param transform - transform between frames, stamped when it was sampled
+        //! @param isDynamic - whether the transform is published to /tf rather than /tf_static
+        void AddTransform(const geometry_msgs::msg::TransformStamped& transform, bool isDynamic);
+
+    private:
+        ////////////////////////////////////////////////////////////////////////
+        // AZ::TickBus::Handler interface implementation
+        void OnTick(float deltaTime, AZ::ScriptTimePoint time) override;
+        int GetTickOrder() override;
+        ////////////////////////////////////////////////////////////////////////
+
+        tf2_ros::TransformBroadcaster m_dynamicBroadcaster;
+        tf2_ros::StaticTransformBroadcaster m_staticBroadcaster;
+        std::vector<geometry_msgs::msg::TransformStamped> m_dynamicTransforms; //!< Reused, so its capacity is kept between publishes.
+        AZStd::unordered_map<AZStd::string, size_t> m_dynamicTransformIndices; //!< Index in m_dynamicTransforms by child frame.
+        std::vector<geometry_msgs::msg::TransformStamped> m_staticTransforms;
+        float m_publishInterval = 0.0f; //!< Minimum time between publishes of dynamic transforms [s], zero for every tick.
+        float m_timeSincePublish = 0.0f;
+    };
+} // namespace ROS2
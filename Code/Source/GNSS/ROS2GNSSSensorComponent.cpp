@@ -73,7 +73,7 @@ namespace ROS2
     void ROS2GNSSSensorComponent::Activate()
     {
         ROS2SensorComponent::Activate();
-        auto ros2Node = ROS2Interface::Get()->GetNode();
+        auto ros2Node = GetNamespaceNode();
         AZ_Assert(m_sensorConfiguration.m_publishersConfigurations.size() == 1, "Invalid configuration of publishers for GNSS sensor");
 
         const auto publisherConfig = m_sensorConfiguration.m_publishersConfigurations[Internal::kGNSSMsgType];
@@ -103,6 +103,7 @@ namespace ROS2
         m_gnssMsg.status.status = sensor_msgs::msg::NavSatStatus::STATUS_SBAS_FIX;
         m_gnssMsg.status.service = sensor_msgs::msg::NavSatStatus::SERVICE_GALILEO;
 
+        m_gnssMsg.header.stamp = GetSampleTimestamp();
         m_gnssPublisher->publish(m_gnssMsg);
     }
 
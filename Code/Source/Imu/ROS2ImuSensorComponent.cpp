@@ -13,7 +13,6 @@
 #include "ROS2/Utilities/ROS2Names.h"
 
 #include <AzCore/Component/Entity.h>
-#include <AzCore/Script/ScriptTimePoint.h>
 #include <AzCore/Serialization/EditContext.h>
 #include <AzCore/Serialization/EditContextConstants.inl>
 #include <AzCore/std/smart_ptr/make_shared.h>
@@ -54,7 +53,7 @@ namespace ROS2
     void ROS2ImuSensorComponent::Activate()
     {
         ROS2SensorComponent::Activate();
-        auto ros2Node = ROS2Interface::Get()->GetNode();
+        auto ros2Node = GetNamespaceNode();
         AZ_Assert(m_sensorConfiguration.m_publishersConfigurations.size() == 1, "Invalid configuration of publishers for IMU sensor");
 
         const auto publisherConfig = m_sensorConfiguration.m_publishersConfigurations[Internal::kImuMsgType];
@@ -64,7 +63,6 @@ namespace ROS2
         InitializeImuMessage();
 
         m_previousPose = GetCurrentPose();
-        m_previousTime = GetCurrentTimeInSec();
     }
 
     void ROS2ImuSensorComponent::Deactivate()
@@ -75,8 +73,8 @@ namespace ROS2
 
     void ROS2ImuSensorComponent::FrequencyTick()
     {
-        const double currentTime = GetCurrentTimeInSec();
-        const auto timeDiff = currentTime - m_previousTime;
+        // Simulation time, as the pose changes with physics substeps, which can be several in a frame
+        const auto timeDiff = GetSampleInterval();
 
         const auto currentPose = GetCurrentPose();
         const auto frequency = 1.0 / timeDiff;
@@ -97,13 +95,12 @@ namespace ROS2
         const auto linearAcceleration = (linearVelocity - m_previousLinearVelocity) * frequency;
 
         // Store current values
-        m_previousTime = currentTime;
         m_previousPose = currentPose;
         m_previousLinearVelocity = linearVelocity;
 
         // Fill message fields
         m_imuMsg.header.frame_id = GetFrameID().data();
-        m_imuMsg.header.stamp = ROS2Interface::Get()->GetROSTimestamp();
+        m_imuMsg.header.stamp = GetSampleTimestamp();
 
         m_imuMsg.angular_velocity = ROS2Conversions::ToROS2Vector3(angularVelocity);
         m_imuMsg.linear_acceleration = ROS2Conversions::ToROS2Vector3(linearAcceleration);
@@ -136,12 +133,6 @@ namespace ROS2
         }
     }
 
-    double ROS2ImuSensorComponent::GetCurrentTimeInSec() const
-    {
-        AZ::ScriptTimePoint timePoint;
-        return timePoint.GetSeconds();
-    }
-
     AZ::Transform ROS2ImuSensorComponent::GetCurrentPose() const
     {
         auto* ros2Frame = Utils::GetGameOrEditorComponent<ROS2FrameComponent>(GetEntity());
@@ -32,13 +32,11 @@ namespace ROS2
         void FrequencyTick() override;
 
         void InitializeImuMessage();
-        double GetCurrentTimeInSec() const;
         AZ::Transform GetCurrentPose() const;
 
         std::shared_ptr<rclcpp::Publisher<sensor_msgs::msg::Imu>> m_imuPublisher;
 
         sensor_msgs::msg::Imu m_imuMsg;
-        double m_previousTime = 0.0;
         AZ::Transform m_previousPose = AZ::Transform::CreateIdentity();
         AZ::Vector3 m_previousLinearVelocity = AZ::Vector3::CreateZero();
     };
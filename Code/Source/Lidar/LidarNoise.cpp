@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project.
+ * For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#include "LidarNoise.h"
+#include <AzCore/Serialization/EditContext.h>
+#include <AzCore/Serialization/EditContextConstants.inl>
+#include <AzCore/std/algorithm.h>
+
+namespace ROS2
+{
+    namespace Internal
+    {
+        //! Uniform float in [0, 1) from 32 bits.
+        float ToUnitFloat(AZ::u32 bits)
+        {
+            return static_cast<float>(bits >> 8) * (1.0f / 16777216.0f);
+        }
+
+        //! Approximately normal value with zero mean and unit variance, from 64 random bits.
+        //! The sum of four uniform numbers (Irwin-Hall) avoids transcendental functions of Box-Muller.
+        float ToStandardNormal(AZ::u64 bits)
+        {
+            constexpr float scale = 1.0f / 65536.0f;
+            const float sum = static_cast<float>(bits & 0xFFFF) + static_cast<float>((bits >> 16) & 0xFFFF) +
+                static_cast<float>((bits >> 32) & 0xFFFF) + static_cast<float>(bits >> 48);
+            constexpr float sqrt3 = 1.7320508f; // Variance of the sum is 1/3
+            return (sum * scale - 2.0f) * sqrt3;
+        }
+    } // namespace Internal
+
+    void LidarNoiseParameters::Reflect(AZ::ReflectContext* context)
+    {
+        if (auto serializeContext = azrtti_cast<AZ::SerializeContext*>(context))
+        {
+            serializeContext->Class<LidarNoiseParameters>()
+                ->Version(1)
+                ->Field("Range std dev", &LidarNoiseParameters::m_rangeStdDev)
+                ->Field("Range std dev per meter", &LidarNoiseParameters::m_rangeStdDevPerMeter)
+                ->Field("Dropout probability at max range", &LidarNoiseParameters::m_dropoutProbabilityAtMaxRange)
+                ->Field("Max range return probability", &LidarNoiseParameters::m_maxRangeReturnProbability)
+                ->Field("Seed", &LidarNoiseParameters::m_seed);
+
+            if (AZ::EditContext* ec = serializeContext->GetEditContext())
+            {
+                ec->Class<LidarNoiseParameters>("Lidar Noise", "Lidar measurement noise")
+                    ->DataElement(
+                        AZ::Edit::UIHandlers::Default,
+                        &LidarNoiseParameters::m_rangeStdDev,
+                        "Range std dev [m]",
+                        "Standard deviation of range noise")
+                    ->Attribute(AZ::Edit::Attributes::Min, 0.0f)
+                    ->DataElement(
+                        AZ::Edit::UIHandlers::Default,
+                        &LidarNoiseParameters::m_rangeStdDevPerMeter,
+                        "Range std dev per meter",
+                        "Standard deviation of range noise added for each meter of range")
+                    ->Attribute(AZ::Edit::Attributes::Min, 0.0f)
+                    ->DataElement(
+                        AZ::Edit::UIHandlers::Default,
+                        &LidarNoiseParameters::m_dropoutProbabilityAtMaxRange,
+                        "Dropout probability",
+                        "Probability of losing a return at max range, it decreases linearly to zero at zero range")
+                    ->Attribute(AZ::Edit::Attributes::Min, 0.0f)
+                    ->Attribute(AZ::Edit::Attributes::Max, 1.0f)
+                    ->DataElement(
+                        AZ::Edit::UIHandlers::Default,
+                        &LidarNoiseParameters::m_maxRangeReturnProbability,
+                        "Max range return probability",
+                        "Probability of a hit being reported at max range")
+                    ->Attribute(AZ::Edit::Attributes::Min, 0.0f)
+                    ->Attribute(AZ::Edit::Attributes::Max, 1.0f)
+                    ->DataElement(
+                        AZ::Edit::UIHandlers::Default, &LidarNoiseParameters::m_seed, "Seed", "Scans are reproducible for the same seed");
+            }
+        }
+    }
+
+    bool LidarNoiseParameters::IsEnabled() const
+    {
+        return m_rangeStdDev > 0.0f || m_rangeStdDevPerMeter > 0.0f || m_dropoutProbabilityAtMaxRange > 0.0f ||
+            m_maxRangeReturnProbability > 0.0f;
+    }
+
+    void LidarNoise::SetParameters(const LidarNoiseParameters& parameters, AZ::u64 sensorKey)
+    {
+        m_parameters = parameters;
+        m_sensorKey = Hash(m_parameters.m_seed, sensorKey);
+        m_scanKey = Hash(m_sensorKey, 0);
+    }
+
+    bool LidarNoise::IsEnabled() const
+    {
+        return m_parameters.IsEnabled();
+    }
+
+    void LidarNoise::BeginScan(AZ::u64 scanIndex)
+    {
+        m_scanKey = Hash(m_sensorKey, scanIndex);
+    }
+
+    LidarNoise::HitResult LidarNoise::ApplyToHit(size_t rayIndex, float& range, float maxRange) const
+    {
+        // Two independent streams per ray: one for return loss, one for range noise
+        const AZ::u64 lossBits = Hash(m_scanKey, 2 * rayIndex);
+        const float dropoutProbability = maxRange > 0.0f ? m_parameters.m_dropoutProbabilityAtMaxRange * range / maxRange : 0.0f;
+        if (Internal::ToUnitFloat(static_cast<AZ::u32>(lossBits)) < dropoutProbability)
+        {
+            return HitResult::Dropped;
+        }
+
+        if (Internal::ToUnitFloat(static_cast<AZ::u32>(lossBits >> 32)) < m_parameters.m_maxRangeReturnProbability)
+        {
+            range = maxRange;
+            return HitResult::MaxRange;
+        }
+
+        const float stdDev = m_parameters.m_rangeStdDev + m_parameters.m_rangeStdDevPerMeter * range;
+        if (stdDev > 0.0f)
+        {
+            const float noisyRange = range + stdDev * Internal::ToStandardNormal(Hash(m_scanKey, 2 * rayIndex + 1));
+            range = AZStd::clamp(noisyRange, 0.0f, maxRange);
+        }
+        return HitResult::Kept;
+    }
+
+    AZ::u64 LidarNoise::Hash(AZ::u64 key, AZ::u64 counter)
+    {
+        AZ::u64 z = key + counter * 0x9E3779B97F4A7C15ull;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+} // namespace ROS2
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project.
+ * For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+#pragma once
+
+#include <AzCore/RTTI/RTTI.h>
+#include <AzCore/Serialization/SerializeContext.h>
+#include <AzCore/base.h>
+
+namespace ROS2
+{
+    //! Configuration of lidar measurement noise. All values of zero mean perfect measurements.
+    struct LidarNoiseParameters
+    {
+    public:
+        AZ_TYPE_INFO(LidarNoiseParameters, "{5C4A8A5B-9B0C-4F4E-8E7B-2E1D1F6A3C71}");
+        static void Reflect(AZ::ReflectContext* context);
+
+        bool IsEnabled() const;
+
+        float m_rangeStdDev = 0.0f; //!< Standard deviation of range noise [m].
+        float m_rangeStdDevPerMeter = 0.0f; //!< Additional standard deviation of range noise, growing with range [m/m].
+        float m_dropoutProbabilityAtMaxRange = 0.0f; //!< Probability of losing a return, growing linearly with range.
+        float m_maxRangeReturnProbability = 0.0f; //!< Probability of a hit reported at max range instead.
+        AZ::u64 m_seed = 0; //!< Scans are reproducible for the same seed.
+    };
+
+    //! Noise applied to lidar hits.
+    //! Random numbers come from a counter-based generator: each is a pure function of the seed, the sensor, the scan and the ray
+    //! index.
+    //! There is no generator state carried between rays, so hits can be processed in any order with reproducible results.
+    class LidarNoise
+    {
+    public:
+        //! Outcome of applying noise to a hit.
+        enum class HitResult
+        {
+            Kept, //!< Hit is kept, with range changed by noise.
+            Dropped, //!< Return is lost and the ray should be treated as a miss.
+            MaxRange //!< Hit is reported at max range.
+        };
+
+        //! @param parameters Noise parameters, with the seed shared by sensors of the same template.
+        //! @param sensorKey Value identifying the sensor, such as its entity id, so that sensors with the same seed differ.
+        void SetParameters(const LidarNoiseParameters& parameters, AZ::u64 sensorKey);
+        bool IsEnabled() const;
+
+        //! Select the noise of a scan. Scans with different indices have different noise.
+        //! @param scanIndex Sequence number of the scan of the sensor, independent of which raycaster casts it.
+        void BeginScan(AZ::u64 scanIndex);
+
+        //! Apply noise to the range of a hit.
+        //! @param rayIndex Index of the ray, which identifies random numbers within a scan.
+        //! @param range Range of the hit, modified in place.
+        //! @param maxRange Maximum range of the lidar.
+        HitResult ApplyToHit(size_t rayIndex, float& range, float maxRange) const;
+
+        //! Counter-based random number (SplitMix64 finalizer of the counter offset by a key).
+        static AZ::u64 Hash(AZ::u64 key, AZ::u64 counter);
+
+    private:
+        LidarNoiseParameters m_parameters;
+        AZ::u64 m_sensorKey = 0; //!< Derived from seed and sensor.
+        AZ::u64 m_scanKey = 0; //!< Derived from sensor key and scan index once per scan.
+    };
+} // namespace ROS2
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project.
+ * For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#include "LidarPointCloud.h"
+#include <cstring>
+
+namespace ROS2
+{
+    void LidarPointCloud::Configure(size_t maxPointCount, LidarTemplate::PointFormat pointFormat)
+    {
+        m_maxPointCount = maxPointCount;
+        m_pointFormat = pointFormat;
+        m_message.fields.clear();
+        m_message.point_step = VisitPointFormat(
+            pointFormat,
+            [this](auto point)
+            {
+                for (const LidarPointField& pointField : LidarPointFields<decltype(point)>::Fields)
+                {
+                    sensor_msgs::msg::PointField field;
+                    field.name = pointField.m_name;
+                    field.offset = pointField.m_offset;
+                    field.datatype = pointField.m_datatype;
+                    field.count = 1;
+                    m_message.fields.push_back(field);
+                }
+                return static_cast<uint32_t>(sizeof(point));
+            });
+        m_message.is_bigendian = false;
+        m_message.is_dense = true;
+        m_message.height = 1;
+        m_message.data.reserve(m_maxPointCount * m_message.point_step);
+        m_scanPoints.resize(m_maxPointCount * m_message.point_step);
+        BeginScan();
+        EndScan();
+    }
+
+    void LidarPointCloud::BeginScan()
+    {
+        m_pointCount = 0;
+    }
+
+    void LidarPointCloud::AddPoints(size_t pointCount)
+    {
+        m_pointCount += pointCount;
+        AZ_Assert(m_pointCount <= m_maxPointCount, "Point count exceeds the configured maximum");
+    }
+
+    void LidarPointCloud::EndScan()
+    {
+        m_message.width = static_cast<uint32_t>(m_pointCount);
+        m_message.row_step = m_message.width * m_message.point_step;
+        // Within reserved capacity, and only points written are copied
+        m_message.data.assign(m_scanPoints.begin(), m_scanPoints.begin() + m_message.row_step * m_message.height);
+    }
+
+    void LidarPointCloud::TruncatePoints(size_t pointCount)
+    {
+        AZ_Assert(pointCount <= m_message.width, "Points can only be removed");
+        m_pointCount = pointCount;
+        m_message.width = static_cast<uint32_t>(pointCount);
+        m_message.row_step = m_message.width * m_message.point_step;
+        m_message.data.resize(m_message.row_step * m_message.height);
+    }
+
+    size_t LidarPointCloud::GetPointCount() const
+    {
+        return m_message.width;
+    }
+
+    LidarTemplate::PointFormat LidarPointCloud::GetPointFormat() const
+    {
+        return m_pointFormat;
+    }
+
+    AZ::Vector3 LidarPointCloud::GetPointPosition(size_t index) const
+    { // All point formats start with x, y, z floats
+        float xyz[3];
+        memcpy(xyz, m_message.data.data() + index * m_message.point_step, sizeof(xyz));
+        return AZ::Vector3(xyz[0], xyz[1], xyz[2]);
+    }
+
+    sensor_msgs::msg::PointCloud2& LidarPointCloud::GetMessage()
+    {
+        return m_message;
+    }
+} // namespace ROS2
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project.
+ * For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+#pragma once
+
+#include "LidarPointTypes.h"
+#include "LidarTemplate.h"
+#include <AzCore/Debug/Trace.h>
+#include <AzCore/Math/Vector3.h>
+#include <AzCore/base.h>
+#include <AzCore/std/containers/vector.h>
+#include <sensor_msgs/msg/point_cloud2.hpp>
+
+namespace ROS2
+{
+    //! PointCloud2 message for lidar scans which is reused between scans.
+    //! Field layout is set once. Points of a scan are written into a buffer sized once for the maximum number of points,
+    //! and copied into the message data, preallocated as well, when the scan ends. The message data has to hold exactly
+    //! the points of the scan, and growing it back to the maximum size for writing would zero-fill it in each scan.
+    class LidarPointCloud
+    {
+    public:
+        //! Set field layout and preallocate data.
+        //! @param maxPointCount Maximum number of points in a scan, typically the number of rays.
+        //! @param pointFormat Format of points, which determines the fields of the message.
+        void Configure(size_t maxPointCount, LidarTemplate::PointFormat pointFormat = LidarTemplate::PointXYZ);
+
+        //! Start writing a new scan. Space for the maximum number of points becomes writable.
+        void BeginScan();
+
+        //! Get space for points to be appended to the current scan.
+        //! @tparam PointT Point type, which must match the configured format.
+        //! @return Pointer past the last point added so far. Space up to the maximum number of points is available.
+        template<typename PointT>
+        PointT* GetNextPoints()
+        {
+            AZ_Assert(sizeof(PointT) == m_message.point_step, "Point type does not match the configured point format");
+            return reinterpret_cast<PointT*>(m_scanPoints.data()) + m_pointCount;
+        }
+
+        //! Get points of a finished scan, such as for filtering them in place.
+        //! @tparam PointT Point type, which must match the configured format.
+        template<typename PointT>
+        PointT* GetPoints()
+        {
+            AZ_Assert(sizeof(PointT) == m_message.point_step, "Point type does not match the configured point format");
+            return reinterpret_cast<PointT*>(m_message.data.data());
+        }
+
+        //! Keep only the first points of a finished scan. This does not release memory.
+        void TruncatePoints(size_t pointCount);
+
+        //! Mark points written through GetNextPoints as a part of the scan.
+        void AddPoints(size_t pointCount);
+
+        //! Finish writing a scan, which can be built in one or many parts, and copy its points into the message.
+        //! This does not release or reallocate memory.
+        void EndScan();
+
+        size_t GetPointCount() const;
+        LidarTemplate::PointFormat GetPointFormat() const;
+
+        //! Position of a point in the lidar frame, valid for every point format.
+        AZ::Vector3 GetPointPosition(size_t index) const;
+
+        sensor_msgs::msg::PointCloud2& GetMessage();
+
+    private:
+        sensor_msgs::msg::PointCloud2 m_message;
+        AZStd::vector<uint8_t> m_scanPoints; //!< Points of the scan being written, kept at the maximum size.
+        size_t m_maxPointCount = 0;
+        size_t m_pointCount = 0; //!< Number of points added since BeginScan.
+        LidarTemplate::PointFormat m_pointFormat = LidarTemplate::PointXYZ;
+    };
+} // namespace ROS2
@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project.
+ * For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#include "LidarPointFilter.h"
+#include <AzCore/Math/MathUtils.h>
+#include <AzCore/Serialization/EditContext.h>
+#include <AzCore/Serialization/EditContextConstants.inl>
+#include <AzCore/std/algorithm.h>
+#include <AzCore/std/limits.h>
+#include <AzCore/std/math.h>
+
+namespace ROS2
+{
+    namespace Internal
+    {
+        constexpr AZ::s64 VoxelCoordinateOffset = 1 << 20; //!< Voxel coordinates are packed into 21 bits each.
+
+        //! Pack integer coordinates of the voxel containing a point into a key.
+        AZ::u64 GetVoxelKey(float x, float y, float z, float inverseVoxelSize)
+        {
+            auto packCoordinate = [inverseVoxelSize](float value)
+            {
+                const AZ::s64 coordinate = static_cast<AZ::s64>(AZStd::floor(value * inverseVoxelSize));
+                return static_cast<AZ::u64>(AZStd::clamp(coordinate + VoxelCoordinateOffset, AZ::s64{ 0 }, 2 * VoxelCoordinateOffset - 1));
+            };
+            return (packCoordinate(x) << 42) | (packCoordinate(y) << 21) | packCoordinate(z);
+        }
+
+        //! SplitMix64 finalizer, so that neighboring voxels do not form clusters in the table.
+        AZ::u64 HashVoxelKey(AZ::u64 key)
+        {
+            key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ull;
+            key = (key ^ (key >> 27)) * 0x94D049BB133111EBull;
+            return key ^ (key >> 31);
+        }
+    } // namespace Internal
+
+    void LidarPointFilterParameters::Reflect(AZ::ReflectContext* context)
+    {
+        if (auto serializeContext = azrtti_cast<AZ::SerializeContext*>(context))
+        {
+            serializeContext->Class<LidarPointFilterParameters>()
+                ->Version(1)
+                ->Field("Ring step", &LidarPointFilterParameters::m_ringStep)
+                ->Field("Column step", &LidarPointFilterParameters::m_columnStep)
+                ->Field("Min range", &LidarPointFilterParameters::m_minRange)
+                ->Field("Max range", &LidarPointFilterParameters::m_maxRange)
+                ->Field("Voxel size", &LidarPointFilterParameters::m_voxelSize);
+
+            if (AZ::EditContext* ec = serializeContext->GetEditContext())
+            {
+                ec->Class<LidarPointFilterParameters>("Lidar Point Filter", "Reduction of lidar scans before publishing")
+                    ->DataElement(
+                        AZ::Edit::UIHandlers::Default, &LidarPointFilterParameters::m_ringStep, "Ring step", "Keep every n-th ring")
+                    ->Attribute(AZ::Edit::Attributes::Min, 1)
+                    ->DataElement(
+                        AZ::Edit::UIHandlers::Default,
+                        &LidarPointFilterParameters::m_columnStep,
+                        "Column step",
+                        "Keep every n-th column (azimuth increment)")
+                    ->Attribute(AZ::Edit::Attributes::Min, 1)
+                    ->DataElement(
+                        AZ::Edit::UIHandlers::Default,
+                        &LidarPointFilterParameters::m_minRange,
+                        "Min range [m]",
+                        "Points closer than this are removed")
+                    ->Attribute(AZ::Edit::Attributes::Min, 0.0f)
+                    ->DataElement(
+                        AZ::Edit::UIHandlers::Default,
+                        &LidarPointFilterParameters::m_maxRange,
+                        "Max range [m]",
+                        "Points further than this are removed. Zero for no limit")
+                    ->Attribute(AZ::Edit::Attributes::Min, 0.0f)
+                    ->DataElement(
+                        AZ::Edit::UIHandlers::Default,
+                        &LidarPointFilterParameters::m_voxelSize,
+                        "Voxel size [m]",
+                        "Each cell of a voxel grid of this size is reduced to one point at the centroid of its points. Zero to disable")
+                    ->Attribute(AZ::Edit::Attributes::Min, 0.0f);
+            }
+        }
+    }
+
+    bool LidarPointFilterParameters::IsRayDecimationEnabled() const
+    {
+        return m_ringStep > 1 || m_columnStep > 1;
+    }
+
+    bool LidarPointFilterParameters::IsPointFilteringEnabled() const
+    {
+        return m_minRange > 0.0f || m_maxRange > 0.0f || m_voxelSize > 0.0f;
+    }
+
+    unsigned int LidarPointFilter::DecimateRays(
+        const LidarPointFilterParameters& parameters,
+        unsigned int layers,
+        AZStd::vector<AZ::Vector3>& directions,
+        AZStd::vector<AZ::u16>& rings,
+        AZStd::vector<float>& timeOffsets)
+    {
+        AZ_Assert(rings.size() == directions.size() && timeOffsets.size() == directions.size(), "Ray tables must have equal sizes");
+        const unsigned int columns = layers > 0 ? static_cast<unsigned int>(directions.size() / layers) : 0;
+        if (!parameters.IsRayDecimationEnabled() || columns == 0)
+        {
+            return columns;
+        }
+
+        const unsigned int ringStep = AZStd::max(parameters.m_ringStep, 1u);
+        const unsigned int columnStep = AZStd::max(parameters.m_columnStep, 1u);
+        size_t keptCount = 0;
+        for (unsigned int column = 0; column < columns; column += columnStep)
+        {
+            for (unsigned int layer = 0; layer < layers; layer += ringStep)
+            { // Kept rays are moved towards the front, never past rays yet to be read
+                const size_t i = size_t{ column } * layers + layer;
+                directions[keptCount] = directions[i];
+                rings[keptCount] = rings[i];
+                timeOffsets[keptCount] = timeOffsets[i];
+                keptCount++;
+            }
+        }
+        directions.resize(keptCount);
+        rings.resize(keptCount);
+        timeOffsets.resize(keptCount);
+        return (columns + columnStep - 1) / columnStep;
+    }
+
+    void LidarPointFilter::Configure(const LidarPointFilterParameters& parameters, size_t maxPointCount)
+    {
+        m_parameters = parameters;
+        m_statistics = {};
+        if (m_parameters.m_voxelSize <= 0.0f)
+        {
+            m_voxels.clear();
+            return;
+        }
+
+        size_t voxelTableSize = 16;
+        while (voxelTableSize < 2 * maxPointCount)
+        {
+            voxelTableSize *= 2;
+        }
+        m_voxels.assign(voxelTableSize, VoxelEntry{});
+        m_generation = 0;
+    }
+
+    LidarPointFilter::VoxelEntry& LidarPointFilter::FindVoxel(AZ::u64 key)
+    {
+        const size_t mask = m_voxels.size() - 1;
+        size_t index = Internal::HashVoxelKey(key) & mask;
+        while (m_voxels[index].m_generation == m_generation && m_voxels[index].m_key != key)
+        { // Linear probing, the table is never more than half full
+            index = (index + 1) & mask;
+        }
+        return m_voxels[index];
+    }
+
+    template<typename PointT>
+    size_t LidarPointFilter::FilterPoints(PointT* points, size_t pointCount)
+    {
+        const float minRangeSquared = m_parameters.m_minRange * m_parameters.m_minRange;
+        const float maxRangeSquared =
+            m_parameters.m_maxRange > 0.0f ? m_parameters.m_maxRange * m_parameters.m_maxRange : AZStd::numeric_limits<float>::max();
+        const bool useVoxels = !m_voxels.empty();
+        const float inverseVoxelSize = useVoxels ? 1.0f / m_parameters.m_voxelSize : 0.0f;
+        if (useVoxels && ++m_generation == 0)
+        { // Generation wrapped around, entries of the previous cycle must not look current
+            m_voxels.assign(m_voxels.size(), VoxelEntry{});
+            m_generation = 1;
+        }
+
+        size_t keptCount = 0;
+        for (size_t i = 0; i < pointCount; i++)
+        {
+            const PointT& point = points[i];
+            const float rangeSquared = point.m_x * point.m_x + point.m_y * point.m_y + point.m_z * point.m_z;
+            if (rangeSquared < minRangeSquared || rangeSquared > maxRangeSquared)
+            {
+                continue;
+            }
+
+            if (useVoxels)
+            {
+                const AZ::u64 key = Internal::GetVoxelKey(point.m_x, point.m_y, point.m_z, inverseVoxelSize);
+                VoxelEntry& voxel = FindVoxel(key);
+                if (voxel.m_generation == m_generation)
+                { // Running mean of positions, other fields are those of the first point
+                    PointT& voxelPoint = points[voxel.m_pointIndex];
+                    voxel.m_pointCount++;
+                    const float weight = 1.0f / voxel.m_pointCount;
+                    voxelPoint.m_x += (point.m_x - voxelPoint.m_x) * weight;
+                    voxelPoint.m_y += (point.m_y - voxelPoint.m_y) * weight;
+                    voxelPoint.m_z += (point.m_z - voxelPoint.m_z) * weight;
+                    continue;
+                }
+                voxel.m_key = key;
+                voxel.m_generation = m_generation;
+                voxel.m_pointIndex = static_cast<AZ::u32>(keptCount);
+                voxel.m_pointCount = 1;
+            }
+
+            if (keptCount != i)
+            {
+                points[keptCount] = point;
+            }
+            keptCount++;
+        }
+        return keptCount;
+    }
+
+    size_t LidarPointFilter::Apply(LidarPointCloud& pointCloud)
+    {
+        const size_t inputCount = pointCloud.GetPointCount();
+        size_t outputCount = inputCount;
+        if (m_parameters.IsPointFilteringEnabled())
+        {
+            outputCount = VisitPointFormat(
+                pointCloud.GetPointFormat(),
+                [&](auto point)
+                {
+                    return FilterPoints(pointCloud.GetPoints<decltype(point)>(), inputCount);
+                });
+            pointCloud.TruncatePoints(outputCount);
+        }
+
+        m_statistics.m_lastInputPointCount = inputCount;
+        m_statistics.m_lastOutputPointCount = outputCount;
+        m_statistics.m_totalInputPointCount += inputCount;
+        m_statistics.m_totalOutputPointCount += outputCount;
+        return outputCount;
+    }
+
+    const LidarPointFilter::Statistics& LidarPointFilter::GetStatistics() const
+    {
+        return m_statistics;
+    }
+} // namespace ROS2
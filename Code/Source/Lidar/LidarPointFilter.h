@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project.
+ * For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+#pragma once
+
+#include "LidarPointCloud.h"
+#include <AzCore/Math/Vector3.h>
+#include <AzCore/RTTI/RTTI.h>
+#include <AzCore/Serialization/SerializeContext.h>
+#include <AzCore/base.h>
+#include <AzCore/std/containers/vector.h>
+
+namespace ROS2
+{
+    //! Configuration of lidar scan reduction done before publishing. Default values keep all points.
+    struct LidarPointFilterParameters
+    {
+    public:
+        AZ_TYPE_INFO(LidarPointFilterParameters, "{8E0D4A63-3C8B-4D36-9B1A-6F2C7D5E9A14}");
+        static void Reflect(AZ::ReflectContext* context);
+
+        //! Whether rings or columns are skipped. This is applied to rays, so that skipped rays are not cast at all.
+        bool IsRayDecimationEnabled() const;
+
+        //! Whether points are filtered after a scan.
+        bool IsPointFilteringEnabled() const;
+
+        unsigned int m_ringStep = 1; //!< Keep every n-th ring (layer).
+        unsigned int m_columnStep = 1; //!< Keep every n-th column (azimuth increment).
+        float m_minRange = 0.0f; //!< Points closer than this are removed [m].
+        float m_maxRange = 0.0f; //!< Points further than this are removed, zero for no limit [m].
+        float m_voxelSize = 0.0f; //!< Edge of voxel grid cells, each cell is reduced to one point. Zero disables the grid [m].
+    };
+
+    //! Reduction of lidar scans: ring and column decimation, range crop and voxel grid downsampling.
+    //! Points are filtered in place in the message buffer. The voxel grid uses an open-addressing hash table which is
+    //! allocated once for the maximum number of points and invalidated between scans by a generation counter,
+    //! so filtering a scan does not allocate or clear memory.
+    class LidarPointFilter
+    {
+    public:
+        //! Point counts before and after filtering.
+        struct Statistics
+        {
+            size_t m_lastInputPointCount = 0;
+            size_t m_lastOutputPointCount = 0;
+            size_t m_totalInputPointCount = 0;
+            size_t m_totalOutputPointCount = 0;
+        };
+
+        //! Remove rays of skipped rings and columns from ray tables.
+        //! Tables must be ordered column by column, as computed by LidarTemplateUtils. Kept rays retain their ring index.
+        //! @param parameters Filter parameters with ring and column steps.
+        //! @param layers Number of rays in each column.
+        //! @return Number of columns left.
+        static unsigned int DecimateRays(
+            const LidarPointFilterParameters& parameters,
+            unsigned int layers,
+            AZStd::vector<AZ::Vector3>& directions,
+            AZStd::vector<AZ::u16>& rings,
+            AZStd::vector<float>& timeOffsets);
+
+        //! Set parameters and allocate the voxel table.
+        //! @param maxPointCount Maximum number of points in a scan, typically the number of rays.
+        void Configure(const LidarPointFilterParameters& parameters, size_t maxPointCount);
+
+        //! Apply range crop and voxel grid to a finished scan, in place.
+        //! Points of a voxel are replaced with the first of them, moved to their centroid.
+        //! @return Number of points left.
+        size_t Apply(LidarPointCloud& pointCloud);
+
+        const Statistics& GetStatistics() const;
+
+    private:
+        //! Entry of the voxel table. It is empty unless its generation is the current one.
+        struct VoxelEntry
+        {
+            AZ::u64 m_key = 0;
+            AZ::u32 m_generation = 0;
+            AZ::u32 m_pointIndex = 0; //!< Index of the point which represents the voxel.
+            AZ::u32 m_pointCount = 0; //!< Number of points merged into it.
+        };
+
+        template<typename PointT>
+        size_t FilterPoints(PointT* points, size_t pointCount);
+
+        //! Find the entry of a voxel, or the empty entry where it should be inserted.
+        VoxelEntry& FindVoxel(AZ::u64 key);
+
+        LidarPointFilterParameters m_parameters;
+        AZStd::vector<VoxelEntry> m_voxels; //!< Power of two sized, at most half full.
+        AZ::u32 m_generation = 0; //!< Advanced for each scan, which empties the table.
+        Statistics m_statistics;
+    };
+} // namespace ROS2
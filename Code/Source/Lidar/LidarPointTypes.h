@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project.
+ * For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+#pragma once
+
+#include "LidarTemplate.h"
+#include <AzCore/Math/Vector3.h>
+#include <AzCore/base.h>
+#include <AzCore/std/containers/array.h>
+#include <cstddef>
+#include <sensor_msgs/msg/point_field.hpp>
+
+namespace ROS2
+{
+    //! Description of a single field of a point, used to fill PointCloud2 fields.
+    struct LidarPointField
+    {
+        const char* m_name;
+        AZ::u32 m_offset;
+        AZ::u8 m_datatype;
+    };
+
+    //! Data acquired for a single ray, written into a point according to its format.
+    struct LidarHit
+    {
+        AZ::Vector3 m_position; //!< Position in the lidar frame.
+        float m_range; //!< Distance from the lidar origin [m].
+        float m_intensity; //!< Return strength in range [0, 1].
+        AZ::u16 m_ring; //!< Index of the layer (beam) which fired the ray.
+        float m_time; //!< Time relative to the beginning of the scan [s].
+    };
+
+    //! Point formats. Each one starts with x, y, z float fields, so that positions can be read regardless of format.
+    //! @see LidarTemplate::PointFormat.
+    struct LidarPointXYZ
+    {
+        float m_x;
+        float m_y;
+        float m_z;
+    };
+
+    struct LidarPointXYZI
+    {
+        float m_x;
+        float m_y;
+        float m_z;
+        float m_intensity;
+    };
+
+    //! Layout compatible with common deskewing and localization packages (ring and per-point time).
+    struct LidarPointXYZIRT
+    {
+        float m_x;
+        float m_y;
+        float m_z;
+        float m_intensity;
+        AZ::u16 m_ring;
+        float m_time;
+    };
+
+    struct LidarPointXYZIRTRange
+    {
+        float m_x;
+        float m_y;
+        float m_z;
+        float m_intensity;
+        AZ::u16 m_ring;
+        float m_time;
+        float m_range;
+    };
+
+    //! Compile-time description of point fields. Specialized for each point format.
+    template<typename PointT>
+    struct LidarPointFields;
+
+    template<>
+    struct LidarPointFields<LidarPointXYZ>
+    {
+        static constexpr AZStd::array<LidarPointField, 3> Fields = { {
+            { "x", offsetof(LidarPointXYZ, m_x), sensor_msgs::msg::PointField::FLOAT32 },
+            { "y", offsetof(LidarPointXYZ, m_y), sensor_msgs::msg::PointField::FLOAT32 },
+            { "z", offsetof(LidarPointXYZ, m_z), sensor_msgs::msg::PointField::FLOAT32 },
+        } };
+    };
+
+    template<>
+    struct LidarPointFields<LidarPointXYZI>
+    {
+        static constexpr AZStd::array<LidarPointField, 4> Fields = { {
+            { "x", offsetof(LidarPointXYZI, m_x), sensor_msgs::msg::PointField::FLOAT32 },
+            { "y", offsetof(LidarPointXYZI, m_y), sensor_msgs::msg::PointField::FLOAT32 },
+            { "z", offsetof(LidarPointXYZI, m_z), sensor_msgs::msg::PointField::FLOAT32 },
+            { "intensity", offsetof(LidarPointXYZI, m_intensity), sensor_msgs::msg::PointField::FLOAT32 },
+        } };
+    };
+
+    template<>
+    struct LidarPointFields<LidarPointXYZIRT>
+    {
+        static constexpr AZStd::array<LidarPointField, 6> Fields = { {
+            { "x", offsetof(LidarPointXYZIRT, m_x), sensor_msgs::msg::PointField::FLOAT32 },
+            { "y", offsetof(LidarPointXYZIRT, m_y), sensor_msgs::msg::PointField::FLOAT32 },
+            { "z", offsetof(LidarPointXYZIRT, m_z), sensor_msgs::msg::PointField::FLOAT32 },
+            { "intensity", offsetof(LidarPointXYZIRT, m_intensity), sensor_msgs::msg::PointField::FLOAT32 },
+            { "ring", offsetof(LidarPointXYZIRT, m_ring), sensor_msgs::msg::PointField::UINT16 },
+            { "time", offsetof(LidarPointXYZIRT, m_time), sensor_msgs::msg::PointField::FLOAT32 },
+        } };
+    };
+
+    template<>
+    struct LidarPointFields<LidarPointXYZIRTRange>
+    {
+        static constexpr AZStd::array<LidarPointField, 7> Fields = { {
+            { "x", offsetof(LidarPointXYZIRTRange, m_x), sensor_msgs::msg::PointField::FLOAT32 },
+            { "y", offsetof(LidarPointXYZIRTRange, m_y), sensor_msgs::msg::PointField::FLOAT32 },
+            { "z", offsetof(LidarPointXYZIRTRange, m_z), sensor_msgs::msg::PointField::FLOAT32 },
+            { "intensity", offsetof(LidarPointXYZIRTRange, m_intensity), sensor_msgs::msg::PointField::FLOAT32 },
+            { "ring", offsetof(LidarPointXYZIRTRange, m_ring), sensor_msgs::msg::PointField::UINT16 },
+            { "time", offsetof(LidarPointXYZIRTRange, m_time), sensor_msgs::msg::PointField::FLOAT32 },
+            { "range", offsetof(LidarPointXYZIRTRange, m_range), sensor_msgs::msg::PointField::FLOAT32 },
+        } };
+    };
+
+    //! Write hit data into a point. Overloads are resolved at compile time, so there is no per-point branching on format.
+    inline void FillPoint(LidarPointXYZ& point, const LidarHit& hit)
+    {
+        point.m_x = hit.m_position.GetX();
+        point.m_y = hit.m_position.GetY();
+        point.m_z = hit.m_position.GetZ();
+    }
+
+    inline void FillPoint(LidarPointXYZI& point, const LidarHit& hit)
+    {
+        point.m_x = hit.m_position.GetX();
+        point.m_y = hit.m_position.GetY();
+        point.m_z = hit.m_position.GetZ();
+        point.m_intensity = hit.m_intensity;
+    }
+
+    inline void FillPoint(LidarPointXYZIRT& point, const LidarHit& hit)
+    {
+        point.m_x = hit.m_position.GetX();
+        point.m_y = hit.m_position.GetY();
+        point.m_z = hit.m_position.GetZ();
+        point.m_intensity = hit.m_intensity;
+        point.m_ring = hit.m_ring;
+        point.m_time = hit.m_time;
+    }
+
+    inline void FillPoint(LidarPointXYZIRTRange& point, const LidarHit& hit)
+    {
+        point.m_x = hit.m_position.GetX();
+        point.m_y = hit.m_position.GetY();
+        point.m_z = hit.m_position.GetZ();
+        point.m_intensity = hit.m_intensity;
+        point.m_ring = hit.m_ring;
+        point.m_time = hit.m_time;
+        point.m_range = hit.m_range;
+    }
+
+    //! Call a generic function with a point of the type matching the format.
+    //! This is the single place where a point format is resolved to a type, typically once per scan.
+    //! @code
+    //! VisitPointFormat(format, [](auto point) { using PointT = decltype(point); ... });
+    //! @endcode
+    template<typename Visitor>
+    decltype(auto) VisitPointFormat(LidarTemplate::PointFormat format, Visitor&& visitor)
+    {
+        switch (format)
+        {
+        case LidarTemplate::PointXYZI:
+            return visitor(LidarPointXYZI{});
+        case LidarTemplate::PointXYZIRT:
+            return visitor(LidarPointXYZIRT{});
+        case LidarTemplate::PointXYZIRTRange:
+            return visitor(LidarPointXYZIRTRange{});
+        case LidarTemplate::PointXYZ:
+        default:
+            return visitor(LidarPointXYZ{});
+        }
+    }
+} // namespace ROS2
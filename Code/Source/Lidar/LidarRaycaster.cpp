@@ -6,7 +6,12 @@
  *
  */
 #include "LidarRaycaster.h"
+#include "LidarPointTypes.h"
+#include "LidarTemplateUtils.h"
 #include <AzCore/Interface/Interface.h>
+#include <AzCore/Jobs/Algorithms.h>
+#include <AzCore/Math/MathUtils.h>
+#include <AzCore/std/algorithm.h>
 #include <AzCore/std/smart_ptr/make_shared.h>
 #include <AzCore/std/smart_ptr/shared_ptr.h>
 #include <AzFramework/Physics/Common/PhysicsSceneQueries.h>
@@ -16,69 +21,351 @@
 
 namespace ROS2
 {
+    namespace Internal
+    {
+        //! Reserve memory in a buffer and report whether it caused an allocation.
+        template<typename T>
+        bool Reserve(AZStd::vector<T>& buffer, size_t size)
+        {
+            if (buffer.capacity() >= size)
+            {
+                return false;
+            }
+            buffer.reserve(size);
+            return true;
+        }
+    } // namespace Internal
+
     void LidarRaycaster::SetRaycasterScene(const AzPhysics::SceneHandle& handle)
     {
         m_sceneHandle = handle;
     }
 
-    // A simplified, non-optimized first version. TODO - generalize results (fields)
-    AZStd::vector<AZ::Vector3> LidarRaycaster::PerformRaycast(
-        const AZ::Vector3& start,
-        const AZStd::vector<AZ::Vector3>& directions,
-        const AZ::Transform& globalToLidarTM,
-        float distance,
-        bool ignoreLayer,
-        unsigned int ignoredLayerIndex) const
+    void LidarRaycaster::SetRayDirections(const AZStd::vector<AZ::Vector3>& localDirections)
     {
-        AZStd::vector<AZ::Vector3> results;
-        if (m_sceneHandle == AzPhysics::InvalidSceneHandle)
+        const size_t rayCount = localDirections.size();
+        m_allocationCount += Internal::Reserve(m_localRayDirections, rayCount);
+        m_allocationCount += Internal::Reserve(m_rayDirections, rayCount);
+        m_allocationCount += Internal::Reserve(m_requests, rayCount);
+        m_allocationCount += Internal::Reserve(m_partialRequests, rayCount);
+        m_allocationCount += Internal::Reserve(m_hitDistances, rayCount);
+        m_allocationCount += Internal::Reserve(m_hitNormals, rayCount);
+        m_allocationCount += Internal::Reserve(m_rayRings, rayCount);
+        m_allocationCount += Internal::Reserve(m_rayTimeOffsets, rayCount);
+        m_localRayDirections.assign(localDirections.begin(), localDirections.end());
+        m_rayRings.resize(rayCount, 0); // Default attributes until SetRayAttributes is called
+        m_rayTimeOffsets.resize(rayCount, 0.0f);
+        m_hitDistances.resize(rayCount);
+        m_hitNormals.resize(rayCount);
+
+        if (m_requests.size() > rayCount)
         {
-            AZ_Warning("LidarRaycaster", false, "No valid scene handle");
-            return results;
+            m_requests.resize(rayCount);
         }
-
-        AzPhysics::SceneQueryRequests requests;
-        requests.reserve(directions.size());
-        results.reserve(directions.size());
-        for (const AZ::Vector3& direction : directions)
-        { // NOTE - performance-wise, consider reusing requests
+        while (m_requests.size() < rayCount)
+        {
             AZStd::shared_ptr<AzPhysics::RayCastRequest> request = AZStd::make_shared<AzPhysics::RayCastRequest>();
-            request->m_start = start;
-            request->m_direction = direction;
-            request->m_distance = distance;
             request->m_reportMultipleHits = false;
-            request->m_filterCallback =
-                [ignoreLayer, ignoredLayerIndex](const AzPhysics::SimulatedBody* simBody, const Physics::Shape* shape)
+            m_requests.emplace_back(AZStd::move(request));
+            m_allocationCount++;
+        }
+
+        SetRange(m_range);
+        UpdateFilterCallback();
+    }
+
+    void LidarRaycaster::SetRayAttributes(const AZStd::vector<AZ::u16>& rings, const AZStd::vector<float>& timeOffsets)
+    {
+        AZ_Assert(rings.size() == m_localRayDirections.size(), "Number of rings must match number of rays");
+        AZ_Assert(timeOffsets.size() == m_localRayDirections.size(), "Number of time offsets must match number of rays");
+        m_allocationCount += Internal::Reserve(m_rayRings, rings.size());
+        m_allocationCount += Internal::Reserve(m_rayTimeOffsets, timeOffsets.size());
+        m_rayRings.assign(rings.begin(), rings.end());
+        m_rayTimeOffsets.assign(timeOffsets.begin(), timeOffsets.end());
+    }
+
+    void LidarRaycaster::SetRange(float range)
+    {
+        m_range = range;
+        for (auto& request : m_requests)
+        {
+            static_cast<AzPhysics::RayCastRequest*>(request.get())->m_distance = range;
+        }
+    }
+
+    void LidarRaycaster::SetIgnoredLayer(bool ignoreLayer, unsigned int ignoredLayerIndex)
+    {
+        m_ignoreLayer = ignoreLayer;
+        m_ignoredLayerIndex = ignoredLayerIndex;
+        UpdateFilterCallback();
+    }
+
+    void LidarRaycaster::UpdateFilterCallback()
+    {
+        m_filterCallback = nullptr;
+        if (m_ignoreLayer)
+        { // Captures by value, so that the callback does not depend on the lifetime of the raycaster
+            m_filterCallback = [ignoredLayerIndex = m_ignoredLayerIndex](
+                                   [[maybe_unused]] const AzPhysics::SimulatedBody* simBody, const Physics::Shape* shape)
             {
-                if (ignoreLayer && (shape->GetCollisionLayer().GetIndex() == ignoredLayerIndex))
+                if (shape->GetCollisionLayer().GetIndex() == ignoredLayerIndex)
                 {
                     return AzPhysics::SceneQuery::QueryHitType::None;
                 }
-                else
+                return AzPhysics::SceneQuery::QueryHitType::Block;
+            };
+        }
+
+        for (auto& request : m_requests)
+        {
+            static_cast<AzPhysics::RayCastRequest*>(request.get())->m_filterCallback = m_filterCallback;
+        }
+    }
+
+    template<typename PointT>
+    size_t LidarRaycaster::WritePoints(size_t rayBegin, size_t rayEnd, PointT* points) const
+    {
+        const bool isNoiseEnabled = m_noise.IsEnabled();
+        size_t pointCount = 0;
+        LidarHit hit;
+        for (size_t i = rayBegin; i < rayEnd; i++)
+        {
+            hit.m_range = m_hitDistances[i];
+            bool isHit = hit.m_range <= m_range;
+            if (isHit)
+            {
+                // Physics materials carry no optical properties, so the return is modeled as a Lambertian reflection
+                hit.m_intensity = AZ::GetAbs(m_hitNormals[i].Dot(m_rayDirections[i]));
+                if (isNoiseEnabled)
+                { // Applied in the same pass, noise of each ray depends only on its index
+                    switch (m_noise.ApplyToHit(i, hit.m_range, m_range))
+                    {
+                    case LidarNoise::HitResult::Kept:
+                        break;
+                    case LidarNoise::HitResult::Dropped:
+                        isHit = false;
+                        break;
+                    case LidarNoise::HitResult::MaxRange:
+                        hit.m_intensity = 0.0f;
+                        break;
+                    }
+                }
+            }
+
+            if (!isHit)
+            {
+                if (!m_addPointsMaxRange)
                 {
-                    return AzPhysics::SceneQuery::QueryHitType::Block;
+                    continue;
                 }
-            };
-            requests.emplace_back(AZStd::move(request));
+                hit.m_range = m_range;
+                hit.m_intensity = 0.0f;
+            }
+            // Rays start at the lidar origin, so the hit in the lidar frame lies along the local direction
+            hit.m_position = m_localRayDirections[i] * hit.m_range;
+            hit.m_ring = m_rayRings[i];
+            hit.m_time = m_rayTimeOffsets[i];
+            FillPoint(points[pointCount++], hit);
         }
+        return pointCount;
+    }
 
-        auto* sceneInterface = AZ::Interface<AzPhysics::SceneInterface>::Get();
-        auto requestResults = sceneInterface->QuerySceneBatch(m_sceneHandle, requests);
-        AZ_Assert(requestResults.size() == directions.size(), "request size should be equal to directions size");
-        for (int i = 0; i < requestResults.size(); i++)
+    void LidarRaycaster::CastStaticRays(const AZ::Vector3& start, size_t rayBegin, size_t rayEnd)
+    {
+        constexpr size_t RaysPerJob = 64 * LidarStaticScene::PacketSize;
+        AZStd::fill(m_hitDistances.begin() + rayBegin, m_hitDistances.begin() + rayEnd, m_range);
+        auto intersectRays = [this, &start](size_t begin, size_t end)
+        {
+            m_staticScene->IntersectRays(
+                start,
+                m_rayDirections.data() + begin,
+                end - begin,
+                m_ignoreLayer,
+                m_ignoredLayerIndex,
+                m_hitDistances.data() + begin,
+                m_hitNormals.data() + begin);
+        };
+
+        const size_t jobCount = (rayEnd - rayBegin + RaysPerJob - 1) / RaysPerJob;
+        if (jobCount <= 1)
+        {
+            intersectRays(rayBegin, rayEnd);
+            return;
+        }
+
+        AZ::parallel_for(
+            size_t{ 0 },
+            jobCount,
+            [&](size_t job)
+            {
+                const size_t begin = rayBegin + job * RaysPerJob;
+                intersectRays(begin, AZStd::min(begin + RaysPerJob, rayEnd));
+            });
+    }
+
+    bool LidarRaycaster::PrepareRaycast(const AZ::Transform& lidarTransform, size_t rayBegin, size_t rayEnd)
+    {
+        rayEnd = AZStd::min(rayEnd, m_requests.size());
+        m_preparedBegin = m_preparedEnd = 0;
+        if (m_sceneHandle == AzPhysics::InvalidSceneHandle)
+        {
+            AZ_Warning("LidarRaycaster", false, "No valid scene handle");
+            return false;
+        }
+
+        if (rayBegin >= rayEnd)
+        {
+            return false;
+        }
+
+        const AZ::Vector3 start = lidarTransform.GetTranslation();
+        LidarTemplateUtils::RotateRayDirections(
+            m_localRayDirections, lidarTransform.GetRotation(), m_rayDirections, rayBegin, rayEnd);
+
+        m_isStaticScenePrepared = m_staticScene && m_staticScene->GetTriangleCount() > 0;
+        if (m_isStaticScenePrepared)
+        {
+            CastStaticRays(start, rayBegin, rayEnd);
+        }
+
+        // With the static scene resolved, rays only need to reach the static hit to find closer dynamic bodies
+        constexpr float MinRequestDistance = 1e-3f;
+        const auto queryType =
+            m_isStaticScenePrepared ? AzPhysics::SceneQuery::QueryType::Dynamic : AzPhysics::SceneQuery::QueryType::StaticAndDynamic;
+        for (size_t i = rayBegin; i < rayEnd; i++)
+        {
+            auto* request = static_cast<AzPhysics::RayCastRequest*>(m_requests[i].get());
+            request->m_start = start;
+            request->m_direction = m_rayDirections[i];
+            request->m_distance = m_isStaticScenePrepared ? AZStd::max(m_hitDistances[i], MinRequestDistance) : m_range;
+            request->m_queryType = queryType;
+        }
+
+        if (rayBegin > 0 || rayEnd < m_requests.size())
+        { // Within reserved capacity, only shared pointers are copied
+            m_partialRequests.assign(m_requests.begin() + rayBegin, m_requests.begin() + rayEnd);
+        }
+        m_preparedBegin = rayBegin;
+        m_preparedEnd = rayEnd;
+        return true;
+    }
+
+    const AzPhysics::SceneQueryRequests& LidarRaycaster::GetPreparedRequests() const
+    {
+        const bool isPartial = m_preparedBegin > 0 || m_preparedEnd < m_requests.size();
+        return isPartial ? m_partialRequests : m_requests;
+    }
+
+    void LidarRaycaster::CompleteRaycast(const AzPhysics::SceneQueryHitsList& requestResults, size_t firstResult)
+    {
+        AZ_Assert(
+            requestResults.size() >= firstResult + m_preparedEnd - m_preparedBegin,
+            "Results should include a result for each prepared ray");
+        constexpr float NoHit = AZStd::numeric_limits<float>::infinity();
+        for (size_t i = m_preparedBegin; i < m_preparedEnd; i++)
         { // TODO - check flag for SceneQuery::ResultFlags::Position
-            const auto& requestResult = requestResults[i];
-            if (requestResult.m_hits.size() > 0)
+            const auto& requestResult = requestResults[firstResult + i - m_preparedBegin];
+            if (!requestResult.m_hits.empty())
             {
-                auto globalHitPoint = requestResult.m_hits[0].m_position;
-                results.push_back(globalToLidarTM.TransformPoint(globalHitPoint)); // Transform back to local frame
+                m_hitDistances[i] = requestResult.m_hits[0].m_distance;
+                m_hitNormals[i] = requestResult.m_hits[0].m_normal;
             }
-            else if (m_addPointsMaxRange)
+            else if (!m_isStaticScenePrepared || m_hitDistances[i] >= m_range)
+            { // Static hits are kept unless a dynamic body is closer
+                m_hitDistances[i] = NoHit;
+            }
+        }
+    }
+
+    size_t LidarRaycaster::WriteResults(LidarPointCloud& pointCloud) const
+    {
+        const size_t pointCount = VisitPointFormat(
+            pointCloud.GetPointFormat(),
+            [&](auto point)
+            {
+                return WritePoints(m_preparedBegin, m_preparedEnd, pointCloud.GetNextPoints<decltype(point)>());
+            });
+        pointCloud.AddPoints(pointCount);
+        return pointCount;
+    }
+
+    size_t LidarRaycaster::WriteResults(sensor_msgs::msg::LaserScan& laserScan) const
+    {
+        AZ_Assert(laserScan.ranges.size() == m_requests.size(), "Laser scan must have a range for each ray");
+        const bool hasIntensities = !laserScan.intensities.empty();
+        const bool isNoiseEnabled = m_noise.IsEnabled();
+        const float noReturnRange = m_addPointsMaxRange ? m_range : AZStd::numeric_limits<float>::infinity();
+        size_t returnCount = 0;
+        for (size_t i = m_preparedBegin; i < m_preparedEnd; i++)
+        {
+            float range = m_hitDistances[i];
+            float intensity = 0.0f;
+            auto result = LidarNoise::HitResult::Dropped; // Nothing hit within range
+            if (range <= m_range)
+            {
+                result = isNoiseEnabled ? m_noise.ApplyToHit(i, range, m_range) : LidarNoise::HitResult::Kept;
+            }
+            switch (result)
+            {
+            case LidarNoise::HitResult::Kept:
+                intensity = AZ::GetAbs(m_hitNormals[i].Dot(m_rayDirections[i]));
+                returnCount++;
+                break;
+            case LidarNoise::HitResult::Dropped:
+                range = noReturnRange;
+                break;
+            case LidarNoise::HitResult::MaxRange:
+                // Reported at max range without intensity, as in point clouds, which is not a valid return of the laser scan
+                break;
+            }
+
+            laserScan.ranges[i] = range;
+            if (hasIntensities)
             {
-                results.push_back(globalToLidarTM.TransformPoint(start + directions[i] * distance));
+                laserScan.intensities[i] = intensity;
             }
         }
-        return results;
+        return returnCount;
+    }
+
+    void LidarRaycaster::CastPreparedRays()
+    {
+        auto* sceneInterface = AZ::Interface<AzPhysics::SceneInterface>::Get();
+        const auto requestResults = sceneInterface->QuerySceneBatch(m_sceneHandle, GetPreparedRequests());
+        AZ_Assert(requestResults.size() == m_preparedEnd - m_preparedBegin, "request size should be equal to number of rays cast");
+        CompleteRaycast(requestResults);
+    }
+
+    size_t LidarRaycaster::PerformRaycast(
+        const AZ::Transform& lidarTransform, LidarPointCloud& pointCloud, size_t rayBegin, size_t rayEnd)
+    {
+        if (!PrepareRaycast(lidarTransform, rayBegin, rayEnd))
+        {
+            return 0;
+        }
+        CastPreparedRays();
+        return WriteResults(pointCloud);
+    }
+
+    size_t LidarRaycaster::PerformRaycast(
+        const AZ::Transform& lidarTransform, sensor_msgs::msg::LaserScan& laserScan, size_t rayBegin, size_t rayEnd)
+    {
+        if (!PrepareRaycast(lidarTransform, rayBegin, rayEnd))
+        {
+            return 0;
+        }
+        CastPreparedRays();
+        return WriteResults(laserScan);
+    }
+
+    AzPhysics::SceneHandle LidarRaycaster::GetSceneHandle() const
+    {
+        return m_sceneHandle;
+    }
+
+    size_t LidarRaycaster::GetRayCount() const
+    {
+        return m_requests.size();
     }
 
     void LidarRaycaster::SetAddPointsMaxRange(bool addPointsMaxRange)
@@ -86,4 +373,23 @@ namespace ROS2
         m_addPointsMaxRange = addPointsMaxRange;
     }
 
+    void LidarRaycaster::SetStaticScene(AZStd::shared_ptr<const LidarStaticScene> staticScene)
+    {
+        m_staticScene = AZStd::move(staticScene);
+    }
+
+    void LidarRaycaster::SetNoise(const LidarNoiseParameters& noiseParameters, AZ::u64 sensorKey)
+    {
+        m_noise.SetParameters(noiseParameters, sensorKey);
+    }
+
+    void LidarRaycaster::SetNoiseScanIndex(AZ::u64 scanIndex)
+    {
+        m_noise.BeginScan(scanIndex);
+    }
+
+    size_t LidarRaycaster::GetAllocationCount() const
+    {
+        return m_allocationCount;
+    }
 } // namespace ROS2
@@ -7,19 +7,29 @@
  */
 #pragma once
 
+#include "LidarNoise.h"
+#include "LidarPointCloud.h"
+#include "LidarStaticScene.h"
 #include <AzCore/Component/EntityId.h>
 #include <AzCore/Math/Transform.h>
 #include <AzCore/Math/Vector3.h>
 #include <AzCore/std/containers/vector.h>
+#include <AzCore/std/limits.h>
+#include <AzFramework/Physics/Common/PhysicsSceneQueries.h>
 #include <AzFramework/Physics/PhysicsScene.h>
+#include <sensor_msgs/msg/laser_scan.hpp>
 
 // TODO - switch to interface
 namespace ROS2
 {
     //! A simple implementation of Lidar operation in terms of raycasting.
+    //! The raycaster owns a pool of scene query requests which is built once for a set of ray directions
+    //! and only updated in place for each scan.
     class LidarRaycaster
     {
     public:
+        static constexpr size_t AllRays = AZStd::numeric_limits<size_t>::max();
+
         //! Set the Scene for the ray-casting.
         //! This should be the scene with the Entity that holds the sensor.
         //! @code
@@ -28,31 +38,135 @@ namespace ROS2
         //! @param scene that will be subject to ray-casting.
         void SetRaycasterScene(const AzPhysics::SceneHandle& handle);
 
-        //! Perform raycast against the current scene.
-        //! @param start Starting point of rays. This is a simplification since there can be multiple starting points
-        //! in real sensors.
-        //! @param directions Directions in which to shoot rays. These should be generated from Lidar configuration.
-        //! @param globalToLidarTM Transform from global to lidar reference frame.
-        //! @param distance Maximum distance for ray-casting.
+        //! Set directions in which to shoot rays. This (re)builds the request pool.
+        //! @param localDirections Ray directions in the lidar frame. These should be generated from Lidar configuration.
+        //! @see LidarTemplateUtils::PopulateRayDirections.
+        void SetRayDirections(const AZStd::vector<AZ::Vector3>& localDirections);
+
+        //! Set per-ray attributes written to point formats which include them.
+        //! @param rings Layer index of each ray. @see LidarTemplateUtils::PopulateRayRings.
+        //! @param timeOffsets Firing time of each ray relative to scan start. @see LidarTemplateUtils::PopulateRayTimeOffsets.
+        //! Both must match ray directions in size and order.
+        void SetRayAttributes(const AZStd::vector<AZ::u16>& rings, const AZStd::vector<float>& timeOffsets);
+
+        //! Set maximum distance for ray-casting. No hits further than distance will be reported.
+        void SetRange(float range);
+
+        //! Set a collision layer to be ignored by all rays.
         //! @param ignoreLayer Should a specified collision layer be ignored
         //! @param ignoredLayerIndex Index of collision layer to be ignored
-        //! @return Hits of raycast. The returned vector size can be anything between zero and size of directions.
-        //! No hits further than distance will be reported.
+        void SetIgnoredLayer(bool ignoreLayer, unsigned int ignoredLayerIndex);
+
+        //! Perform raycast against the current scene.
+        //! @param lidarTransform Current world transform of the lidar. Rays start at its translation.
+        //! This is a simplification since there can be multiple starting points in real sensors.
+        //! @param pointCloud Output for hits of raycast in the lidar frame. Points are appended directly into the message buffer
+        //! in the format it was configured with. It must be configured for at least the number of rays and a scan must be begun.
+        //! @param rayBegin Index of the first ray to cast.
+        //! @param rayEnd Index past the last ray to cast. By default, rays are cast up to the last one.
+        //! A range of rays is used to cast a part of the scan, such as an azimuth slice.
+        //! @return Number of points added, which can be anything between zero and number of rays cast.
         // TODO - different starting points for rays, distance from reference point, noise models, rotating mirror sim, other
-        // TODO - customized settings. Encapsulate in lidar definition and pass in constructor, update transform.
-        AZStd::vector<AZ::Vector3> PerformRaycast(
-            const AZ::Vector3& start,
-            const AZStd::vector<AZ::Vector3>& directions,
-            const AZ::Transform& globalToLidarTM,
-            float distance,
-            bool ignoreLayer,
-            unsigned int ignoredLayerIndex) const;
+        size_t PerformRaycast(
+            const AZ::Transform& lidarTransform, LidarPointCloud& pointCloud, size_t rayBegin = 0, size_t rayEnd = AllRays);
+
+        //! Perform raycast against the current scene and write ranges directly, without computing points.
+        //! This is meant for planar lidars, where ranges are published as they are.
+        //! @param lidarTransform Current world transform of the lidar.
+        //! @param laserScan Output message. Its ranges, and intensities unless empty, must be sized to the number of rays.
+        //! The range of each ray is written at the index of the ray. Rays without a return get +Inf (as in REP 117),
+        //! or max range if points at max range are added.
+        //! @param rayBegin Index of the first ray to cast.
+        //! @param rayEnd Index past the last ray to cast. By default, rays are cast up to the last one.
+        //! @return Number of returns.
+        size_t PerformRaycast(
+            const AZ::Transform& lidarTransform, sensor_msgs::msg::LaserScan& laserScan, size_t rayBegin = 0, size_t rayEnd = AllRays);
+
+        //! Prepare scene query requests of a range of rays for the lidar pose, without querying the scene.
+        //! This is the first phase of a raycast split for batching queries of many lidars: prepared requests are queried
+        //! together with requests of other raycasters, results are given back with CompleteRaycast and written with WriteResults.
+        //! Rays are resolved against the static scene here, if there is one.
+        //! @return False if there is nothing to cast.
+        //! @see PerformRaycast for parameters.
+        bool PrepareRaycast(const AZ::Transform& lidarTransform, size_t rayBegin = 0, size_t rayEnd = AllRays);
+
+        //! Requests of prepared rays, in the order of rays. They stay valid until the next raycast.
+        const AzPhysics::SceneQueryRequests& GetPreparedRequests() const;
+
+        //! Take results of prepared requests.
+        //! @param requestResults Results of a batch which includes prepared requests.
+        //! @param firstResult Index of the result of the first prepared request in the batch.
+        void CompleteRaycast(const AzPhysics::SceneQueryHitsList& requestResults, size_t firstResult = 0);
+
+        //! Append points of a completed raycast to a point cloud. @see PerformRaycast.
+        //! @return Number of points added.
+        size_t WriteResults(LidarPointCloud& pointCloud) const;
+
+        //! Write ranges of a completed raycast to a laser scan. @see PerformRaycast.
+        //! @return Number of returns.
+        size_t WriteResults(sensor_msgs::msg::LaserScan& laserScan) const;
+
+        AzPhysics::SceneHandle GetSceneHandle() const;
+
+        size_t GetRayCount() const;
 
         //! If true the raycaster will also include points at maximum range when nothing was hit
         void SetAddPointsMaxRange(bool addPointsMaxRange);
 
+        //! Set static scene geometry to resolve rays against before querying the physics scene.
+        //! When set, the physics scene is only queried for dynamic bodies, up to the static hit of each ray.
+        //! @param staticScene Static scene of the physics scene of the raycaster, or nullptr to query the physics scene only.
+        //! @see LidarStaticScene::Get.
+        void SetStaticScene(AZStd::shared_ptr<const LidarStaticScene> staticScene);
+
+        //! Set noise applied to hits.
+        //! @param sensorKey Value identifying the sensor, so that sensors with the same seed have different noise.
+        //! @see LidarNoise::SetParameters.
+        void SetNoise(const LidarNoiseParameters& noiseParameters, AZ::u64 sensorKey);
+
+        //! Select the noise of the next scan. Call before casting its first ray.
+        //! @param scanIndex Sequence number of the scan of the sensor, so that noise does not repeat between raycasters of a sensor.
+        void SetNoiseScanIndex(AZ::u64 scanIndex);
+
+        //! Number of heap allocations of buffers owned by the raycaster, such as its requests.
+        //! They only happen when ray directions change, scans reuse the buffers.
+        //! @note Allocations outside of the raycaster are not counted: the physics scene returns results of a query batch
+        //! in a new list with a hit list per ray, and long ranges of rays cast against the static scene are split into jobs.
+        size_t GetAllocationCount() const;
+
     private:
-        AzPhysics::SceneHandle m_sceneHandle;
+        void UpdateFilterCallback();
+
+        //! Query the physics scene with prepared requests of this raycaster only, and complete the raycast.
+        void CastPreparedRays();
+
+        //! Intersect a range of rays with the static scene, in parallel for long ranges.
+        void CastStaticRays(const AZ::Vector3& start, size_t rayBegin, size_t rayEnd);
+
+        //! Convert hits of a range of rays to points. Instantiated per point format.
+        template<typename PointT>
+        size_t WritePoints(size_t rayBegin, size_t rayEnd, PointT* points) const;
+
+        AzPhysics::SceneHandle m_sceneHandle = AzPhysics::InvalidSceneHandle;
         bool m_addPointsMaxRange{ false };
+        float m_range = 1.0f;
+        bool m_ignoreLayer = false;
+        unsigned int m_ignoredLayerIndex = 0;
+
+        AZStd::vector<AZ::Vector3> m_localRayDirections;
+        AZStd::vector<AZ::Vector3> m_rayDirections; //!< Directions rotated to the lidar orientation of the current scan.
+        AZStd::vector<AZ::u16> m_rayRings;
+        AZStd::vector<float> m_rayTimeOffsets;
+        AzPhysics::SceneQueryRequests m_requests; //!< Pool of requests, one per ray, updated in place.
+        AZStd::vector<float> m_hitDistances; //!< Distance of the hit of each ray, infinite for no hit.
+        AZStd::vector<AZ::Vector3> m_hitNormals; //!< Normal at the hit of each ray.
+        size_t m_preparedBegin = 0; //!< Range of rays of the current raycast.
+        size_t m_preparedEnd = 0;
+        bool m_isStaticScenePrepared = false; //!< Whether prepared rays were resolved against the static scene.
+        AZStd::shared_ptr<const LidarStaticScene> m_staticScene;
+        LidarNoise m_noise;
+        AzPhysics::SceneQueryRequests m_partialRequests; //!< Requests for a range of rays, shared with m_requests.
+        AzPhysics::SceneQuery::FilterCallback m_filterCallback; //!< Shared by all requests.
+        size_t m_allocationCount = 0;
     };
 } // namespace ROS2
@@ -0,0 +1,508 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project.
+ * For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#include "LidarStaticScene.h"
+#include <AzCore/Debug/Trace.h>
+#include <AzCore/Interface/Interface.h>
+#include <AzCore/Jobs/JobFunction.h>
+#include <AzCore/Math/MathUtils.h>
+#include <AzCore/Math/Transform.h>
+#include <AzCore/std/algorithm.h>
+#include <AzCore/std/containers/array.h>
+#include <AzCore/std/parallel/lock.h>
+#include <AzCore/std/parallel/mutex.h>
+#include <AzCore/std/smart_ptr/make_shared.h>
+#include <AzCore/std/smart_ptr/weak_ptr.h>
+#include <AzFramework/Physics/Common/PhysicsSceneQueries.h>
+#include <AzFramework/Physics/PhysicsScene.h>
+#include <AzFramework/Physics/Shape.h>
+#include <AzFramework/Physics/SimulatedBodies/StaticRigidBody.h>
+#include <algorithm>
+
+namespace ROS2
+{
+    namespace Internal
+    {
+        constexpr AZ::u32 MaxLeafTriangles = 4;
+        constexpr size_t MaxTraversalDepth = 64;
+        constexpr AZ::u32 MaxStaticShapes = 65536;
+        constexpr float WorldSize = 100000.0f; //!< Extent of the volume in which static colliders are gathered [m].
+
+        //! Static scene of a physics scene and its rebuild in progress.
+        struct CachedStaticScene
+        {
+            AzPhysics::SceneHandle m_sceneHandle;
+            AZStd::weak_ptr<const LidarStaticScene> m_scene; //!< Lidars keep it alive, the cache only refers to it.
+            AZStd::shared_ptr<LidarStaticScene> m_pendingScene; //!< Kept alive by the cache until it is ready.
+        };
+
+        struct StaticSceneCache
+        {
+            AZStd::mutex m_mutex;
+            AZStd::vector<CachedStaticScene> m_scenes;
+        };
+
+        StaticSceneCache& GetStaticSceneCache()
+        {
+            static StaticSceneCache cache;
+            return cache;
+        }
+
+        bool IsStaticBody(AzPhysics::SceneHandle sceneHandle, AzPhysics::SimulatedBodyHandle bodyHandle)
+        {
+            auto* sceneInterface = AZ::Interface<AzPhysics::SceneInterface>::Get();
+            auto* body = sceneInterface->GetSimulatedBodyFromHandle(sceneHandle, bodyHandle);
+            return body == nullptr || azrtti_istypeof<AzPhysics::StaticRigidBody>(body); // Unknown bodies are assumed static
+        }
+
+        void Cross(const float a[3], const float b[3], float result[3])
+        {
+            result[0] = a[1] * b[2] - a[2] * b[1];
+            result[1] = a[2] * b[0] - a[0] * b[2];
+            result[2] = a[0] * b[1] - a[1] * b[0];
+        }
+
+        float Dot(const float a[3], const float b[3])
+        {
+            return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+        }
+    } // namespace Internal
+
+    AZStd::shared_ptr<const LidarStaticScene> LidarStaticScene::Get(AzPhysics::SceneHandle sceneHandle)
+    {
+        auto& cache = Internal::GetStaticSceneCache();
+        AZStd::lock_guard<AZStd::mutex> lock(cache.m_mutex);
+        auto cached = AZStd::find_if(
+            cache.m_scenes.begin(),
+            cache.m_scenes.end(),
+            [&sceneHandle](const auto& entry)
+            {
+                return entry.m_sceneHandle == sceneHandle;
+            });
+        if (cached == cache.m_scenes.end())
+        {
+            cached = cache.m_scenes.insert(cache.m_scenes.end(), Internal::CachedStaticScene{ sceneHandle, {}, {} });
+        }
+
+        AZStd::shared_ptr<const LidarStaticScene> staticScene = cached->m_scene.lock();
+        if (cached->m_pendingScene && cached->m_pendingScene->IsReady())
+        {
+            staticScene = AZStd::move(cached->m_pendingScene);
+            cached->m_scene = staticScene;
+        }
+
+        if ((!staticScene || staticScene->IsOutdated()) && !cached->m_pendingScene)
+        { // The previous scene is still returned while the new one is built
+            cached->m_pendingScene = AZStd::make_shared<LidarStaticScene>();
+            StartBuildFromPhysicsScene(cached->m_pendingScene, sceneHandle);
+        }
+        return staticScene;
+    }
+
+    LidarStaticScene::~LidarStaticScene()
+    {
+        AZ::TransformNotificationBus::MultiHandler::BusDisconnect();
+    }
+
+    void LidarStaticScene::StartBuildFromPhysicsScene(
+        const AZStd::shared_ptr<LidarStaticScene>& staticScene, AzPhysics::SceneHandle sceneHandle)
+    {
+        auto* sceneInterface = AZ::Interface<AzPhysics::SceneInterface>::Get();
+
+        // Handlers are registered first, so that no change during gathering is missed
+        LidarStaticScene* scene = staticScene.get();
+        scene->m_bodyAddedHandler = AzPhysics::SceneEvents::OnSimulationBodyAdded::Handler(
+            [scene](AzPhysics::SceneHandle sceneHandle, AzPhysics::SimulatedBodyHandle bodyHandle)
+            {
+                if (Internal::IsStaticBody(sceneHandle, bodyHandle))
+                {
+                    scene->m_isOutdated = true;
+                }
+            });
+        scene->m_bodyRemovedHandler = AzPhysics::SceneEvents::OnSimulationBodyRemoved::Handler(
+            [scene](AzPhysics::SceneHandle sceneHandle, AzPhysics::SimulatedBodyHandle bodyHandle)
+            {
+                if (Internal::IsStaticBody(sceneHandle, bodyHandle))
+                {
+                    scene->m_isOutdated = true;
+                }
+            });
+        sceneInterface->RegisterSimulationBodyAddedHandler(sceneHandle, scene->m_bodyAddedHandler);
+        sceneInterface->RegisterSimulationBodyRemovedHandler(sceneHandle, scene->m_bodyRemovedHandler);
+
+        AzPhysics::OverlapRequest request = AzPhysics::OverlapRequestHelpers::CreateBoxOverlapRequest(
+            AZ::Vector3(Internal::WorldSize), AZ::Transform::CreateIdentity());
+        request.m_queryType = AzPhysics::SceneQuery::QueryType::Static;
+        request.m_maxResults = Internal::MaxStaticShapes;
+        const AzPhysics::SceneQueryHits result = sceneInterface->QueryScene(sceneHandle, &request);
+        AZ_Warning(
+            "LidarStaticScene",
+            result.m_hits.size() < Internal::MaxStaticShapes,
+            "Static shape limit reached, some static colliders are not included in lidar static scene");
+
+        AZStd::vector<AZ::Vector3> vertices;
+        AZStd::vector<AZ::u32> indices;
+        AZStd::vector<AZ::u8> triangleLayers;
+        AZStd::vector<AZ::Vector3> shapeVertices;
+        AZStd::vector<AZ::u32> shapeIndices;
+        for (const auto& hit : result.m_hits)
+        {
+            auto* body = sceneInterface->GetSimulatedBodyFromHandle(sceneHandle, hit.m_bodyHandle);
+            if (hit.m_shape == nullptr || body == nullptr)
+            {
+                continue;
+            }
+
+            // Static bodies follow their entities when they are moved or teleported
+            const AZ::EntityId entityId = body->GetEntityId();
+            if (entityId.IsValid() && !scene->BusIsConnectedId(entityId))
+            {
+                scene->AZ::TransformNotificationBus::MultiHandler::BusConnect(entityId);
+            }
+
+            // Geometry is given in the frame of the shape, which is posed relative to its body
+            const auto [localPosition, localRotation] = hit.m_shape->GetLocalPose();
+            const AZ::Transform shapeTransform =
+                body->GetTransform() * AZ::Transform::CreateFromQuaternionAndTranslation(localRotation, localPosition);
+            shapeVertices.clear();
+            shapeIndices.clear();
+            hit.m_shape->GetGeometry(shapeVertices, shapeIndices, nullptr);
+
+            const auto firstVertex = static_cast<AZ::u32>(vertices.size());
+            for (const AZ::Vector3& vertex : shapeVertices)
+            {
+                vertices.push_back(shapeTransform.TransformPoint(vertex));
+            }
+
+            const size_t firstIndex = indices.size();
+            if (shapeIndices.empty())
+            { // Triangle list without indices
+                for (AZ::u32 i = 0; i < shapeVertices.size(); i++)
+                {
+                    indices.push_back(firstVertex + i);
+                }
+            }
+            else
+            {
+                for (const AZ::u32 index : shapeIndices)
+                {
+                    indices.push_back(firstVertex + index);
+                }
+            }
+            triangleLayers.insert(
+                triangleLayers.end(), (indices.size() - firstIndex) / 3, static_cast<AZ::u8>(hit.m_shape->GetCollisionLayer().GetIndex()));
+        }
+
+        // Scans keep using the previous scene meanwhile, so building does not stall the main thread
+        AZ::Job* buildJob = AZ::CreateJobFunction(
+            [staticScene,
+             vertices = AZStd::move(vertices),
+             indices = AZStd::move(indices),
+             triangleLayers = AZStd::move(triangleLayers),
+             shapeCount = result.m_hits.size()]()
+            {
+                staticScene->Build(vertices, indices, triangleLayers);
+                AZ_TracePrintf(
+                    "LidarStaticScene",
+                    "Built lidar static scene of %zu triangles from %zu shapes\n",
+                    staticScene->GetTriangleCount(),
+                    shapeCount);
+                staticScene->m_isReady = true;
+            },
+            true);
+        buildJob->Start();
+    }
+
+    void LidarStaticScene::Build(
+        const AZStd::vector<AZ::Vector3>& vertices, const AZStd::vector<AZ::u32>& indices, const AZStd::vector<AZ::u8>& triangleLayers)
+    {
+        m_nodes.clear();
+        m_triangles.clear();
+        m_normals.clear();
+        m_layers.clear();
+
+        const size_t triangleCount = indices.size() / 3;
+        AZ_Assert(triangleLayers.size() == triangleCount, "Collision layer is needed for each triangle");
+
+        // Degenerate triangles can not be hit and are dropped
+        AZStd::vector<AZ::u32> order;
+        AZStd::vector<AZ::Vector3> centroids(triangleCount);
+        order.reserve(triangleCount);
+        for (AZ::u32 triangle = 0; triangle < triangleCount; triangle++)
+        {
+            const AZ::Vector3& v0 = vertices[indices[3 * triangle]];
+            const AZ::Vector3& v1 = vertices[indices[3 * triangle + 1]];
+            const AZ::Vector3& v2 = vertices[indices[3 * triangle + 2]];
+            if ((v1 - v0).Cross(v2 - v0).GetLengthSq() > 0.0f)
+            {
+                order.push_back(triangle);
+                centroids[triangle] = (v0 + v1 + v2) / 3.0f;
+            }
+        }
+        if (order.empty())
+        {
+            return;
+        }
+
+        struct BuildTask
+        {
+            AZ::u32 m_node;
+            AZ::u32 m_first;
+            AZ::u32 m_count;
+        };
+        AZStd::vector<BuildTask> tasks;
+        tasks.push_back({ 0, 0, static_cast<AZ::u32>(order.size()) });
+        m_nodes.reserve(2 * order.size() / Internal::MaxLeafTriangles + 1);
+        m_nodes.emplace_back();
+        while (!tasks.empty())
+        {
+            const BuildTask task = tasks.back();
+            tasks.pop_back();
+
+            AZ::Vector3 boundsMin = vertices[indices[3 * order[task.m_first]]];
+            AZ::Vector3 boundsMax = boundsMin;
+            AZ::Vector3 centroidMin = centroids[order[task.m_first]];
+            AZ::Vector3 centroidMax = centroidMin;
+            for (AZ::u32 i = task.m_first; i < task.m_first + task.m_count; i++)
+            {
+                for (AZ::u32 corner = 0; corner < 3; corner++)
+                {
+                    const AZ::Vector3& vertex = vertices[indices[3 * order[i] + corner]];
+                    boundsMin = boundsMin.GetMin(vertex);
+                    boundsMax = boundsMax.GetMax(vertex);
+                }
+                centroidMin = centroidMin.GetMin(centroids[order[i]]);
+                centroidMax = centroidMax.GetMax(centroids[order[i]]);
+            }
+
+            Node& node = m_nodes[task.m_node];
+            boundsMin.StoreToFloat3(node.m_min);
+            boundsMax.StoreToFloat3(node.m_max);
+
+            // Split at the median of the longest axis of centroid bounds, found in linear time with nth_element
+            const AZ::Vector3 centroidExtent = centroidMax - centroidMin;
+            int axis = centroidExtent.GetX() > centroidExtent.GetY() ? 0 : 1;
+            axis = centroidExtent.GetZ() > centroidExtent.GetElement(axis) ? 2 : axis;
+            if (task.m_count <= Internal::MaxLeafTriangles || centroidExtent.GetElement(axis) <= 0.0f)
+            {
+                node.m_first = task.m_first;
+                node.m_count = task.m_count;
+                continue;
+            }
+
+            const AZ::u32 middle = task.m_first + task.m_count / 2;
+            std::nth_element(
+                order.begin() + task.m_first,
+                order.begin() + middle,
+                order.begin() + task.m_first + task.m_count,
+                [&centroids, axis](AZ::u32 a, AZ::u32 b)
+                {
+                    return centroids[a].GetElement(axis) < centroids[b].GetElement(axis);
+                });
+
+            const auto leftChild = static_cast<AZ::u32>(m_nodes.size());
+            node.m_first = leftChild;
+            node.m_count = 0;
+            m_nodes.emplace_back(); // Invalidates node
+            m_nodes.emplace_back();
+            tasks.push_back({ leftChild, task.m_first, middle - task.m_first });
+            tasks.push_back({ leftChild + 1, middle, task.m_first + task.m_count - middle });
+        }
+
+        // Triangles are stored in leaf order
+        m_triangles.resize(order.size());
+        m_normals.resize(order.size());
+        m_layers.resize(order.size());
+        for (size_t i = 0; i < order.size(); i++)
+        {
+            const AZ::u32 triangle = order[i];
+            const AZ::Vector3& v0 = vertices[indices[3 * triangle]];
+            const AZ::Vector3 edge1 = vertices[indices[3 * triangle + 1]] - v0;
+            const AZ::Vector3 edge2 = vertices[indices[3 * triangle + 2]] - v0;
+            v0.StoreToFloat3(m_triangles[i].m_vertex);
+            edge1.StoreToFloat3(m_triangles[i].m_edge1);
+            edge2.StoreToFloat3(m_triangles[i].m_edge2);
+            m_normals[i] = edge1.Cross(edge2).GetNormalized();
+            m_layers[i] = triangleLayers[triangle];
+        }
+    }
+
+    size_t LidarStaticScene::GetTriangleCount() const
+    {
+        return m_triangles.size();
+    }
+
+    bool LidarStaticScene::IsOutdated() const
+    {
+        return m_isOutdated;
+    }
+
+    bool LidarStaticScene::IsReady() const
+    {
+        return m_isReady;
+    }
+
+    void LidarStaticScene::OnTransformChanged([[maybe_unused]] const AZ::Transform& local, [[maybe_unused]] const AZ::Transform& world)
+    {
+        m_isOutdated = true;
+    }
+
+    void LidarStaticScene::IntersectRays(
+        const AZ::Vector3& origin,
+        const AZ::Vector3* directions,
+        size_t rayCount,
+        bool ignoreLayer,
+        unsigned int ignoredLayerIndex,
+        float* distances,
+        AZ::Vector3* normals) const
+    {
+        if (m_nodes.empty())
+        {
+            return;
+        }
+
+        float originArray[3];
+        origin.StoreToFloat3(originArray);
+        for (size_t first = 0; first < rayCount; first += PacketSize)
+        {
+            IntersectPacket(
+                originArray,
+                directions + first,
+                AZStd::min(PacketSize, rayCount - first),
+                ignoreLayer,
+                ignoredLayerIndex,
+                distances + first,
+                normals + first);
+        }
+    }
+
+    void LidarStaticScene::IntersectPacket(
+        const float origin[3],
+        const AZ::Vector3* directions,
+        size_t rayCount,
+        bool ignoreLayer,
+        unsigned int ignoredLayerIndex,
+        float* distances,
+        AZ::Vector3* normals) const
+    {
+        // Rays are stored by component, so that loops over the packet are straightforward to vectorize.
+        // Unused lanes of an incomplete packet have a negative max distance and never hit anything.
+        AZStd::array<float, PacketSize> direction[3];
+        AZStd::array<float, PacketSize> inverseDirection[3];
+        AZStd::array<float, PacketSize> maxDistance;
+        AZStd::array<AZ::s32, PacketSize> hitTriangle;
+        for (size_t ray = 0; ray < PacketSize; ray++)
+        {
+            const AZ::Vector3 rayDirection = ray < rayCount ? directions[ray] : AZ::Vector3::CreateAxisX();
+            for (int axis = 0; axis < 3; axis++)
+            {
+                direction[axis][ray] = rayDirection.GetElement(axis);
+                inverseDirection[axis][ray] = 1.0f / direction[axis][ray];
+            }
+            maxDistance[ray] = ray < rayCount ? distances[ray] : -1.0f;
+            hitTriangle[ray] = -1;
+        }
+
+        AZStd::array<AZ::u32, Internal::MaxTraversalDepth> stack;
+        size_t stackSize = 0;
+        stack[stackSize++] = 0;
+        while (stackSize > 0)
+        {
+            const Node& node = m_nodes[stack[--stackSize]];
+
+            bool isAnyRayInside = false;
+            for (size_t ray = 0; ray < PacketSize; ray++)
+            {
+                float nearDistance = 0.0f;
+                float farDistance = maxDistance[ray];
+                for (int axis = 0; axis < 3; axis++)
+                {
+                    const float t1 = (node.m_min[axis] - origin[axis]) * inverseDirection[axis][ray];
+                    const float t2 = (node.m_max[axis] - origin[axis]) * inverseDirection[axis][ray];
+                    nearDistance = AZStd::max(nearDistance, AZStd::min(t1, t2));
+                    farDistance = AZStd::min(farDistance, AZStd::max(t1, t2));
+                }
+                isAnyRayInside |= nearDistance <= farDistance;
+            }
+            if (!isAnyRayInside)
+            {
+                continue;
+            }
+
+            if (node.m_count == 0)
+            { // Nearer child is visited first, judged by the first ray of the packet
+                const Node& left = m_nodes[node.m_first];
+                const Node& right = m_nodes[node.m_first + 1];
+                float leftDistance = 0.0f;
+                float rightDistance = 0.0f;
+                for (int axis = 0; axis < 3; axis++)
+                {
+                    leftDistance += (left.m_min[axis] + left.m_max[axis]) * direction[axis][0];
+                    rightDistance += (right.m_min[axis] + right.m_max[axis]) * direction[axis][0];
+                }
+                const bool isLeftNearer = leftDistance < rightDistance;
+                AZ_Assert(stackSize + 2 <= stack.size(), "Lidar static scene is too deep");
+                stack[stackSize++] = isLeftNearer ? node.m_first + 1 : node.m_first;
+                stack[stackSize++] = isLeftNearer ? node.m_first : node.m_first + 1;
+                continue;
+            }
+
+            for (AZ::u32 triangleIndex = node.m_first; triangleIndex < node.m_first + node.m_count; triangleIndex++)
+            {
+                if (ignoreLayer && m_layers[triangleIndex] == ignoredLayerIndex)
+                {
+                    continue;
+                }
+
+                // Moller-Trumbore rewritten for a shared origin: every term which does not depend on the ray direction
+                // is computed once per triangle, leaving three dot products per ray.
+                const Triangle& triangle = m_triangles[triangleIndex];
+                float toOrigin[3];
+                for (int axis = 0; axis < 3; axis++)
+                {
+                    toOrigin[axis] = origin[axis] - triangle.m_vertex[axis];
+                }
+                float normal[3];
+                float uTerm[3];
+                float vTerm[3];
+                Internal::Cross(triangle.m_edge1, triangle.m_edge2, normal);
+                Internal::Cross(triangle.m_edge2, toOrigin, uTerm);
+                Internal::Cross(toOrigin, triangle.m_edge1, vTerm);
+                const float distanceTerm = Internal::Dot(triangle.m_edge2, vTerm);
+
+                for (size_t ray = 0; ray < PacketSize; ray++)
+                {
+                    const float rayDirection[3] = { direction[0][ray], direction[1][ray], direction[2][ray] };
+                    const float determinant = -Internal::Dot(rayDirection, normal);
+                    if (AZ::GetAbs(determinant) < 1e-12f)
+                    {
+                        continue;
+                    }
+                    const float inverseDeterminant = 1.0f / determinant;
+                    const float u = Internal::Dot(rayDirection, uTerm) * inverseDeterminant;
+                    const float v = Internal::Dot(rayDirection, vTerm) * inverseDeterminant;
+                    const float distance = distanceTerm * inverseDeterminant;
+                    if (u >= 0.0f && v >= 0.0f && u + v <= 1.0f && distance > 0.0f && distance < maxDistance[ray])
+                    {
+                        maxDistance[ray] = distance;
+                        hitTriangle[ray] = static_cast<AZ::s32>(triangleIndex);
+                    }
+                }
+            }
+        }
+
+        for (size_t ray = 0; ray < rayCount; ray++)
+        {
+            if (hitTriangle[ray] >= 0)
+            {
+                distances[ray] = maxDistance[ray];
+                normals[ray] = m_normals[hitTriangle[ray]];
+            }
+        }
+    }
+} // namespace ROS2
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project.
+ * For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+#pragma once
+
+#include <AzCore/Component/TransformBus.h>
+#include <AzCore/Math/Vector3.h>
+#include <AzCore/base.h>
+#include <AzCore/std/containers/vector.h>
+#include <AzCore/std/parallel/atomic.h>
+#include <AzCore/std/smart_ptr/shared_ptr.h>
+#include <AzFramework/Physics/Common/PhysicsEvents.h>
+#include <AzFramework/Physics/Common/PhysicsTypes.h>
+
+namespace ROS2
+{
+    //! Geometry of static colliders of a physics scene, in a bounding volume hierarchy (BVH) for lidar raycasting.
+    //! Static geometry rarely changes, so it is gathered once and rays against it are resolved without the physics engine,
+    //! which then only needs to be queried for dynamic bodies. The hierarchy is rebuilt in the background when it changes.
+    //! Rays of a lidar share their origin, so they are traversed in packets of neighboring rays.
+    class LidarStaticScene : private AZ::TransformNotificationBus::MultiHandler
+    {
+    public:
+        //! Number of rays traversed together.
+        static constexpr size_t PacketSize = 8;
+
+        //! Get the static scene of a physics scene, shared by all lidars in it. Call from the main thread.
+        //! It is built in a job on first use, and rebuilt when static bodies are added, removed or moved. The previous scene
+        //! is returned until the rebuilt one is ready.
+        //! @return The static scene, or nullptr until the first build is ready. Holders keep a valid scene until they get the
+        //! rebuilt one.
+        static AZStd::shared_ptr<const LidarStaticScene> Get(AzPhysics::SceneHandle sceneHandle);
+
+        LidarStaticScene() = default;
+        ~LidarStaticScene();
+        LidarStaticScene(const LidarStaticScene&) = delete;
+        LidarStaticScene& operator=(const LidarStaticScene&) = delete;
+
+        //! Build the hierarchy from triangles in the world frame.
+        //! @param vertices Triangle vertices.
+        //! @param indices Three vertex indices per triangle.
+        //! @param triangleLayers Collision layer index of each triangle.
+        void Build(
+            const AZStd::vector<AZ::Vector3>& vertices, const AZStd::vector<AZ::u32>& indices, const AZStd::vector<AZ::u8>& triangleLayers);
+
+        size_t GetTriangleCount() const;
+
+        //! Whether static bodies of the physics scene changed since their geometry was gathered for this scene.
+        bool IsOutdated() const;
+
+        //! Find nearest intersections of rays with a common origin.
+        //! @param origin Origin of all rays.
+        //! @param directions Unit direction of each ray.
+        //! @param rayCount Number of rays.
+        //! @param ignoreLayer Should triangles of a collision layer be ignored.
+        //! @param ignoredLayerIndex Index of the ignored collision layer.
+        //! @param distances Maximum distance of each ray on input. Distance of the nearest hit on output, unchanged if nothing was hit.
+        //! @param normals Normal of the nearest hit, written only for rays which hit.
+        void IntersectRays(
+            const AZ::Vector3& origin,
+            const AZ::Vector3* directions,
+            size_t rayCount,
+            bool ignoreLayer,
+            unsigned int ignoredLayerIndex,
+            float* distances,
+            AZ::Vector3* normals) const;
+
+    private:
+        //! Node of the hierarchy. Children of an inner node are stored next to each other.
+        struct Node
+        {
+            float m_min[3];
+            float m_max[3];
+            AZ::u32 m_first; //!< First triangle of a leaf, or the left child of an inner node.
+            AZ::u32 m_count; //!< Number of triangles of a leaf, zero for an inner node.
+        };
+
+        //! Triangle prepared for the Moller-Trumbore intersection test.
+        struct Triangle
+        {
+            float m_vertex[3];
+            float m_edge1[3];
+            float m_edge2[3];
+        };
+
+        void IntersectPacket(
+            const float origin[3],
+            const AZ::Vector3* directions,
+            size_t rayCount,
+            bool ignoreLayer,
+            unsigned int ignoredLayerIndex,
+            float* distances,
+            AZ::Vector3* normals) const;
+
+        //! Gather static collider geometry of a physics scene and start a job building the hierarchy from it.
+        //! @see IsReady.
+        static void StartBuildFromPhysicsScene(const AZStd::shared_ptr<LidarStaticScene>& staticScene, AzPhysics::SceneHandle sceneHandle);
+
+        //! Whether the job building the hierarchy has finished.
+        bool IsReady() const;
+
+        ////////////////////////////////////////////////////////////////////////
+        // AZ::TransformNotificationBus::MultiHandler interface implementation
+        void OnTransformChanged(const AZ::Transform& local, const AZ::Transform& world) override;
+        ////////////////////////////////////////////////////////////////////////
+
+        AZStd::vector<Node> m_nodes;
+        AZStd::vector<Triangle> m_triangles;
+        AZStd::vector<AZ::Vector3> m_normals; //!< Unit normal of each triangle.
+        AZStd::vector<AZ::u8> m_layers; //!< Collision layer index of each triangle.
+
+        AZStd::atomic_bool m_isReady{ false };
+        AZStd::atomic_bool m_isOutdated{ false };
+        AzPhysics::SceneEvents::OnSimulationBodyAdded::Handler m_bodyAddedHandler;
+        AzPhysics::SceneEvents::OnSimulationBodyRemoved::Handler m_bodyRemovedHandler;
+    };
+} // namespace ROS2
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project.
+ * For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+#pragma once
+
+#include <AzCore/Interface/Interface.h>
+#include <AzCore/RTTI/RTTI.h>
+
+namespace ROS2
+{
+    class LidarRaycaster;
+
+    //! Lidar which has its scans cast by ROS2LidarSystemComponent, in a single physics query batch with scans of other lidars.
+    class LidarBatchClient
+    {
+    public:
+        virtual ~LidarBatchClient() = default;
+
+        //! Number of rays of the scan due, used to budget rays cast in a frame.
+        virtual size_t GetBatchedScanRayCount() const = 0;
+
+        //! Prepare the scan due for casting.
+        //! @return Raycaster with prepared requests (@see LidarRaycaster::PrepareRaycast), or nullptr if there is nothing to cast.
+        virtual LidarRaycaster* PrepareBatchedScan() = 0;
+
+        //! Called when the raycaster returned by PrepareBatchedScan has its raycast completed. Write and publish the scan.
+        virtual void FinishBatchedScan() = 0;
+    };
+
+    //! Interface to the lidar system component, which casts scans of all lidars due in a frame together.
+    //! Use this API through LidarSystemInterface, on the main thread.
+    class LidarSystemRequests
+    {
+    public:
+        AZ_RTTI(LidarSystemRequests, "{3F1E8C2A-7D4B-4B0E-A6C5-92D8E1F07B36}");
+        virtual ~LidarSystemRequests() = default;
+
+        //! Queue a scan of a lidar to be cast in the next batch, at the end of the current frame.
+        //! Scans above the per-frame ray budget are kept in the queue for the next frames.
+        virtual void SubmitScan(LidarBatchClient* client) = 0;
+
+        //! Remove queued scans of a lidar, such as when it is deactivated.
+        virtual void CancelScans(LidarBatchClient* client) = 0;
+    };
+
+    using LidarSystemInterface = AZ::Interface<LidarSystemRequests>;
+} // namespace ROS2
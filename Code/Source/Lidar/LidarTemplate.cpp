@@ -14,10 +14,11 @@ namespace ROS2
 {
     void LidarTemplate::Reflect(AZ::ReflectContext* context)
     {
+        LidarNoiseParameters::Reflect(context);
         if (auto serializeContext = azrtti_cast<AZ::SerializeContext*>(context))
         {
             serializeContext->Class<LidarTemplate>()
-                ->Version(1)
+                ->Version(4)
                 ->Field("Name", &LidarTemplate::m_name)
                 ->Field("Layers", &LidarTemplate::m_layers)
                 ->Field("Points per layer", &LidarTemplate::m_numberOfIncrements)
@@ -26,7 +27,11 @@ namespace ROS2
                 ->Field("Min vertical angle", &LidarTemplate::m_minVAngle)
                 ->Field("Max vertical angle", &LidarTemplate::m_maxVAngle)
                 ->Field("Max range", &LidarTemplate::m_maxRange)
-                ->Field("Max range add points", &LidarTemplate::m_addPointsAtMax);
+                ->Field("Max range add points", &LidarTemplate::m_addPointsAtMax)
+                ->Field("Point format", &LidarTemplate::m_pointFormat)
+                ->Field("Beam elevations", &LidarTemplate::m_beamElevations)
+                ->Field("Beam azimuth offsets", &LidarTemplate::m_beamAzimuthOffsets)
+                ->Field("Noise", &LidarTemplate::m_noiseParameters);
 
             if (AZ::EditContext* ec = serializeContext->GetEditContext())
             {
@@ -58,7 +63,24 @@ namespace ROS2
                         AZ::Edit::UIHandlers::Default,
                         &LidarTemplate::m_addPointsAtMax,
                         "Points at Max",
-                        "If set true LiDAR will produce points at max range for free space");
+                        "If set true LiDAR will produce points at max range for free space")
+                    ->DataElement(
+                        AZ::Edit::UIHandlers::ComboBox, &LidarTemplate::m_pointFormat, "Point format", "Fields of published points")
+                    ->EnumAttribute(LidarTemplate::PointXYZ, "x, y, z")
+                    ->EnumAttribute(LidarTemplate::PointXYZI, "x, y, z, intensity")
+                    ->EnumAttribute(LidarTemplate::PointXYZIRT, "x, y, z, intensity, ring, time")
+                    ->EnumAttribute(LidarTemplate::PointXYZIRTRange, "x, y, z, intensity, ring, time, range")
+                    ->DataElement(
+                        AZ::Edit::UIHandlers::Default,
+                        &LidarTemplate::m_beamElevations,
+                        "Beam elevations [Deg]",
+                        "Elevation of each beam in ring order. Overrides vertical angles when set, must have one entry per layer")
+                    ->DataElement(
+                        AZ::Edit::UIHandlers::Default,
+                        &LidarTemplate::m_beamAzimuthOffsets,
+                        "Beam azimuth offsets [Deg]",
+                        "Horizontal offset of each beam in ring order. Optional, must have one entry per layer when set")
+                    ->DataElement(AZ::Edit::UIHandlers::Default, &LidarTemplate::m_noiseParameters, "Noise", "Measurement noise");
             }
         }
     }
@@ -7,28 +7,39 @@
  */
 #pragma once
 
+#include "LidarNoise.h"
 #include <AzCore/RTTI/RTTI.h>
 #include <AzCore/Serialization/SerializeContext.h>
+#include <AzCore/std/containers/vector.h>
 #include <AzCore/std/string/string.h>
 
 namespace ROS2
 {
     //! Configuration reflecting a specific Lidar model.
     //! This is meant to capture differences between different Lidars available on the market.
-    //! @note Current implementation is simplified. Rays in real lidars are often not uniformly
-    //! distributed among angular range, there is noise etc.
+    //! Beams are either uniformly distributed between min and max vertical angle, or given explicitly per beam.
+    //! Models other than the generic one are loaded from the settings registry, see LidarTemplateUtils::GetTemplate.
     struct LidarTemplate
     {
     public:
         AZ_TYPE_INFO(LidarTemplate, "{9E9EF583-733D-4450-BBA0-ADD4D1BEFBF2}");
         static void Reflect(AZ::ReflectContext* context);
 
-        // TODO - implement more models. Add at least one realistic model.
         enum LidarModel
         {
             Generic3DLidar
         };
 
+        //! Fields of published points. Formats other than PointXYZ are needed e.g. for deskewing.
+        //! @see LidarPointTypes.h for the layout of each format.
+        enum PointFormat
+        {
+            PointXYZ,
+            PointXYZI,
+            PointXYZIRT,
+            PointXYZIRTRange
+        };
+
         LidarModel m_model;
         AZStd::string m_name;
         float m_minHAngle = 0.0f;
@@ -39,5 +50,13 @@ namespace ROS2
         unsigned int m_numberOfIncrements = 0;
         float m_maxRange = 0.0f;
         bool m_addPointsAtMax = false;
+        PointFormat m_pointFormat = PointXYZ;
+
+        //! Elevation of each beam [Deg], in ring order. When empty, beams are uniformly distributed between vertical angles.
+        AZStd::vector<float> m_beamElevations;
+        //! Horizontal offset of each beam from the firing azimuth [Deg], in ring order. When empty, beams are vertically aligned.
+        AZStd::vector<float> m_beamAzimuthOffsets;
+
+        LidarNoiseParameters m_noiseParameters;
     };
 } // namespace ROS2
@@ -8,49 +8,146 @@
 
 #include "LidarTemplateUtils.h"
 #include <AzCore/Math/MathUtils.h>
-#include <AzCore/Math/Matrix4x4.h>
+#include <AzCore/Math/Matrix3x3.h>
 #include <AzCore/Math/Quaternion.h>
 #include <AzCore/Math/Vector3.h>
+#include <AzCore/Settings/SettingsRegistry.h>
 #include <AzCore/Utils/Utils.h>
-#include <AzCore/std/containers/unordered_map.h>
+#include <AzCore/std/algorithm.h>
+#include <AzCore/std/containers/map.h>
 
 namespace ROS2
 {
-    LidarTemplate LidarTemplateUtils::GetTemplate(LidarTemplate::LidarModel model)
+    namespace Internal
     {
-        static std::unordered_map<LidarTemplate::LidarModel, LidarTemplate> templates;
+        LidarTemplate CreateGenericTemplate()
+        {
+            return { /*.m_model = */ LidarTemplate::Generic3DLidar,
+                     /*.m_name = */ LidarTemplateUtils::GenericLidarName,
+                     /*.m_minHAngle = */ -180.0f,
+                     /*.m_maxHAngle = */ 180.0f,
+                     /*.m_minVAngle = */ 35.0f,
+                     /*.m_maxVAngle = */ -35.0f,
+                     /*.m_layers = */ 24,
+                     /*.m_numberOfIncrements = */ 924,
+                     /*.m_maxRange = */ 100.0f };
+        }
 
-        if (templates.empty())
+        //! All templates by name: the generic one and valid ones from the settings registry.
+        const AZStd::map<AZStd::string, LidarTemplate>& GetTemplates()
         {
-            LidarTemplate generic3DLidar = { /*.m_model = */ LidarTemplate::Generic3DLidar,
-                                             /*.m_name = */ "GenericLidar",
-                                             /*.m_minHAngle = */ -180.0f,
-                                             /*.m_maxHAngle = */ 180.0f,
-                                             /*.m_minVAngle = */ 35.0f,
-                                             /*.m_maxVAngle = */ -35.0f,
-                                             /*.m_layers = */ 24,
-                                             /*.m_numberOfIncrements = */ 924,
-                                             /*.m_maxRange = */ 100.0f };
-            templates[LidarTemplate::Generic3DLidar] = generic3DLidar;
-        }
-
-        auto it = templates.find(model);
+            static const AZStd::map<AZStd::string, LidarTemplate> templates = []()
+            {
+                AZStd::map<AZStd::string, LidarTemplate> loadedTemplates;
+                loadedTemplates[LidarTemplateUtils::GenericLidarName] = CreateGenericTemplate();
+
+                auto* settingsRegistry = AZ::SettingsRegistry::Get();
+                if (!settingsRegistry)
+                {
+                    return loadedTemplates;
+                }
+
+                for (size_t i = 0;; i++)
+                {
+                    const auto path = AZStd::string::format("%s/%zu", LidarTemplateUtils::LidarModelsRegistryPath, i);
+                    LidarTemplate lidarTemplate;
+                    lidarTemplate.m_model = LidarTemplate::Generic3DLidar;
+                    if (!settingsRegistry->GetObject(lidarTemplate, path))
+                    {
+                        break;
+                    }
+
+                    if (lidarTemplate.m_layers == 0)
+                    { // Number of layers can be omitted when given by the beam table
+                        lidarTemplate.m_layers = static_cast<unsigned int>(lidarTemplate.m_beamElevations.size());
+                    }
+
+                    const auto validation = LidarTemplateUtils::ValidateTemplate(lidarTemplate);
+                    if (!validation.IsSuccess())
+                    {
+                        AZ_Warning(
+                            "LidarTemplateUtils", false, "Skipping lidar model at %s: %s", path.c_str(), validation.GetError().c_str());
+                        continue;
+                    }
+                    loadedTemplates[lidarTemplate.m_name] = AZStd::move(lidarTemplate);
+                }
+                return loadedTemplates;
+            }();
+            return templates;
+        }
+    } // namespace Internal
+
+    LidarTemplate LidarTemplateUtils::GetTemplate(LidarTemplate::LidarModel model)
+    {
+        if (model == LidarTemplate::Generic3DLidar)
+        { // Does not touch the settings registry, so it is safe to use before reflection
+            return Internal::CreateGenericTemplate();
+        }
+        return LidarTemplate(); // TODO - handle it
+    }
+
+    LidarTemplate LidarTemplateUtils::GetTemplate(const AZStd::string& name)
+    {
+        const auto& templates = Internal::GetTemplates();
+        auto it = templates.find(name);
         if (it == templates.end())
         {
-            return LidarTemplate(); // TODO - handle it
+            AZ_Warning("LidarTemplateUtils", false, "Unknown lidar model %s, using %s instead", name.c_str(), GenericLidarName);
+            return Internal::CreateGenericTemplate();
         }
-
         return it->second;
     }
 
+    AZStd::vector<AZStd::string> LidarTemplateUtils::GetTemplateNames()
+    {
+        AZStd::vector<AZStd::string> names;
+        for (const auto& [name, lidarTemplate] : Internal::GetTemplates())
+        {
+            names.push_back(name);
+        }
+        return names;
+    }
+
+    AZ::Outcome<void, AZStd::string> LidarTemplateUtils::ValidateTemplate(const LidarTemplate& t)
+    {
+        if (t.m_name.empty())
+        {
+            return AZ::Failure(AZStd::string("Missing name"));
+        }
+        if (t.m_layers == 0 || t.m_numberOfIncrements == 0)
+        {
+            return AZ::Failure(AZStd::string("Number of layers and points per layer must be positive"));
+        }
+        if (t.m_maxRange <= 0.0f)
+        {
+            return AZ::Failure(AZStd::string("Max range must be positive"));
+        }
+        if (!t.m_beamElevations.empty() && t.m_beamElevations.size() != t.m_layers)
+        {
+            return AZ::Failure(AZStd::string::format(
+                "Beam elevation table has %zu entries, expected one per layer (%u)", t.m_beamElevations.size(), t.m_layers));
+        }
+        if (!t.m_beamAzimuthOffsets.empty() && t.m_beamAzimuthOffsets.size() != t.m_layers)
+        {
+            return AZ::Failure(AZStd::string::format(
+                "Beam azimuth offset table has %zu entries, expected one per layer (%u)", t.m_beamAzimuthOffsets.size(), t.m_layers));
+        }
+        for (const float elevation : t.m_beamElevations)
+        {
+            if (elevation < -90.0f || elevation > 90.0f)
+            {
+                return AZ::Failure(AZStd::string::format("Beam elevation %f is out of [-90, 90] range", elevation));
+            }
+        }
+        return AZ::Success();
+    }
+
     size_t LidarTemplateUtils::TotalPointCount(const LidarTemplate& t)
     {
         return t.m_layers * t.m_numberOfIncrements;
     }
 
-    // TODO - lidars in reality do not have uniform distributions - populating needs to be defined per model
-    AZStd::vector<AZ::Vector3> LidarTemplateUtils::PopulateRayDirections(
-        const LidarTemplate& lidarTemplate, const AZ::Vector3& rootRotation)
+    AZStd::vector<AZ::Vector3> LidarTemplateUtils::PopulateRayDirections(const LidarTemplate& lidarTemplate)
     {
         const float minVertAngle = AZ::DegToRad(lidarTemplate.m_minVAngle);
         const float maxVertAngle = AZ::DegToRad(lidarTemplate.m_maxVAngle);
@@ -60,24 +157,95 @@ namespace ROS2
         const float verticalStep = (maxVertAngle - minVertAngle) / static_cast<float>(lidarTemplate.m_layers);
         const float horizontalStep = (maxHorAngle - minHorAngle) / static_cast<float>(lidarTemplate.m_numberOfIncrements);
 
-        AZStd::vector<AZ::Vector3> directions;
+        const bool hasBeamElevations = lidarTemplate.m_beamElevations.size() == lidarTemplate.m_layers;
+        const bool hasBeamAzimuthOffsets = lidarTemplate.m_beamAzimuthOffsets.size() == lidarTemplate.m_layers;
+        AZ_Warning(
+            "LidarTemplateUtils",
+            hasBeamElevations || lidarTemplate.m_beamElevations.empty(),
+            "Beam elevation table does not match the number of layers and is ignored");
+        AZ_Warning(
+            "LidarTemplateUtils",
+            hasBeamAzimuthOffsets || lidarTemplate.m_beamAzimuthOffsets.empty(),
+            "Beam azimuth offset table does not match the number of layers and is ignored");
 
-        for (int incr = 0; incr < lidarTemplate.m_numberOfIncrements; incr++)
+        // Trigonometry is evaluated once per layer and once per increment instead of once per ray.
+        // Azimuth offsets are applied with the angle sum identities.
+        AZStd::vector<float> layerSin(lidarTemplate.m_layers);
+        AZStd::vector<float> layerCos(lidarTemplate.m_layers);
+        AZStd::vector<float> layerOffsetSin(lidarTemplate.m_layers, 0.0f);
+        AZStd::vector<float> layerOffsetCos(lidarTemplate.m_layers, 1.0f);
+        for (unsigned int layer = 0; layer < lidarTemplate.m_layers; layer++)
         {
-            for (int layer = 0; layer < lidarTemplate.m_layers; layer++)
+            const float pitch =
+                hasBeamElevations ? AZ::DegToRad(lidarTemplate.m_beamElevations[layer]) : minVertAngle + layer * verticalStep;
+            layerSin[layer] = AZ::Sin(pitch);
+            layerCos[layer] = AZ::Cos(pitch);
+            if (hasBeamAzimuthOffsets)
             {
-                // TODO: also include roll. Move to quaternions to avoid abnormalities
-                const float pitch = minVertAngle + layer * verticalStep + rootRotation.GetY();
-                const float yaw = minHorAngle + incr * horizontalStep + rootRotation.GetZ();
-
-                const float x = AZ::Cos(yaw) * AZ::Cos(pitch);
-                const float y = AZ::Sin(yaw) * AZ::Cos(pitch);
-                const float z = AZ::Sin(pitch);
+                const float offset = AZ::DegToRad(lidarTemplate.m_beamAzimuthOffsets[layer]);
+                layerOffsetSin[layer] = AZ::Sin(offset);
+                layerOffsetCos[layer] = AZ::Cos(offset);
+            }
+        }
 
-                directions.push_back(AZ::Vector3(x, y, z));
+        AZStd::vector<AZ::Vector3> directions;
+        directions.reserve(TotalPointCount(lidarTemplate));
+        for (unsigned int incr = 0; incr < lidarTemplate.m_numberOfIncrements; incr++)
+        {
+            const float yaw = minHorAngle + incr * horizontalStep;
+            const float yawCos = AZ::Cos(yaw);
+            const float yawSin = AZ::Sin(yaw);
+            for (unsigned int layer = 0; layer < lidarTemplate.m_layers; layer++)
+            {
+                const float beamYawCos = yawCos * layerOffsetCos[layer] - yawSin * layerOffsetSin[layer];
+                const float beamYawSin = yawSin * layerOffsetCos[layer] + yawCos * layerOffsetSin[layer];
+                directions.emplace_back(beamYawCos * layerCos[layer], beamYawSin * layerCos[layer], layerSin[layer]);
             }
         }
 
         return directions;
     }
+
+    AZStd::vector<AZ::u16> LidarTemplateUtils::PopulateRayRings(const LidarTemplate& lidarTemplate)
+    {
+        AZStd::vector<AZ::u16> rings;
+        rings.reserve(TotalPointCount(lidarTemplate));
+        for (unsigned int incr = 0; incr < lidarTemplate.m_numberOfIncrements; incr++)
+        {
+            for (unsigned int layer = 0; layer < lidarTemplate.m_layers; layer++)
+            {
+                rings.push_back(static_cast<AZ::u16>(layer));
+            }
+        }
+        return rings;
+    }
+
+    AZStd::vector<float> LidarTemplateUtils::PopulateRayTimeOffsets(const LidarTemplate& lidarTemplate, float scanDuration)
+    {
+        const float columnDuration = lidarTemplate.m_numberOfIncrements > 0 ? scanDuration / lidarTemplate.m_numberOfIncrements : 0.0f;
+        AZStd::vector<float> timeOffsets;
+        timeOffsets.reserve(TotalPointCount(lidarTemplate));
+        for (unsigned int incr = 0; incr < lidarTemplate.m_numberOfIncrements; incr++)
+        {
+            timeOffsets.insert(timeOffsets.end(), lidarTemplate.m_layers, incr * columnDuration);
+        }
+        return timeOffsets;
+    }
+
+    void LidarTemplateUtils::RotateRayDirections(
+        const AZStd::vector<AZ::Vector3>& localDirections,
+        const AZ::Quaternion& rotation,
+        AZStd::vector<AZ::Vector3>& directions,
+        size_t begin,
+        size_t end)
+    {
+        // Rotation as a matrix is cheaper to apply to a large number of vectors than a quaternion
+        const AZ::Matrix3x3 rotationMatrix = AZ::Matrix3x3::CreateFromQuaternion(rotation);
+        directions.resize(localDirections.size());
+        end = AZStd::min(end, localDirections.size());
+        for (size_t i = begin; i < end; i++)
+        {
+            directions[i] = rotationMatrix * localDirections[i];
+        }
+    }
 } // namespace ROS2
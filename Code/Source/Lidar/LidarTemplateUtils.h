@@ -8,8 +8,12 @@
 #pragma once
 
 #include "LidarTemplate.h"
+#include <AzCore/Math/Quaternion.h>
 #include <AzCore/Math/Vector3.h>
+#include <AzCore/Outcome/Outcome.h>
 #include <AzCore/std/containers/vector.h>
+#include <AzCore/std/limits.h>
+#include <AzCore/std/string/string.h>
 
 namespace ROS2
 {
@@ -17,13 +21,53 @@ namespace ROS2
     class LidarTemplateUtils
     {
     public:
+        //! Name of the built-in generic model, which is always available.
+        static constexpr const char* GenericLidarName = "GenericLidar";
+        //! Settings registry path of an array of lidar templates, such as the models defined in Registry/lidar_models.setreg.
+        //! Projects can add their own sensor models under this path.
+        static constexpr const char* LidarModelsRegistryPath = "/O3DE/ROS2/LidarModels";
+
         static LidarTemplate GetTemplate(LidarTemplate::LidarModel model);
+
+        //! Get a template by its name. Templates from the settings registry are loaded and validated on first use.
+        //! @return The template, or the generic template if there is no valid template with such name.
+        static LidarTemplate GetTemplate(const AZStd::string& name);
+
+        //! Names of all available templates, sorted.
+        static AZStd::vector<AZStd::string> GetTemplateNames();
+
+        //! Check whether a template describes a valid lidar, with beam tables matching the number of layers.
+        static AZ::Outcome<void, AZStd::string> ValidateTemplate(const LidarTemplate& t);
+
         static size_t TotalPointCount(const LidarTemplate& t);
 
-        //! Compute ray directions based on lidar model and rotation.
-        //! @param model Lidar model to use. Note that different models will produce different number of rays.
-        //! @param rootRotation Root rotation as Euler angles in radians.
-        //! @return All ray directions which can be used to perform ray-casting simulation of lidar operation.
-        static AZStd::vector<AZ::Vector3> PopulateRayDirections(const LidarTemplate& lidarTemplate, const AZ::Vector3& rootRotation);
+        //! Compute ray directions in the lidar reference frame based on lidar model.
+        //! The result does not depend on lidar pose and is meant to be computed once and cached.
+        //! @param lidarTemplate Lidar template to use. Note that different models will produce different number of rays.
+        //! @return All ray directions (unit vectors) in the local frame of the lidar.
+        //! @see RotateRayDirections to obtain directions for the current lidar orientation.
+        static AZStd::vector<AZ::Vector3> PopulateRayDirections(const LidarTemplate& lidarTemplate);
+
+        //! Compute index of the layer (ring) of each ray, in the order of PopulateRayDirections.
+        static AZStd::vector<AZ::u16> PopulateRayRings(const LidarTemplate& lidarTemplate);
+
+        //! Compute firing time of each ray relative to the beginning of the scan, in the order of PopulateRayDirections.
+        //! Rays are fired column by column, all layers of a column at once.
+        //! @param scanDuration Duration of a full scan (revolution) in seconds.
+        static AZStd::vector<float> PopulateRayTimeOffsets(const LidarTemplate& lidarTemplate, float scanDuration);
+
+        //! Rotate cached local ray directions to match lidar orientation.
+        //! @param localDirections Ray directions in the lidar frame, as returned by PopulateRayDirections.
+        //! @param rotation Lidar orientation (typically the world rotation of the lidar entity).
+        //! @param directions Output for rotated directions. It is resized to match localDirections and can be reused between calls
+        //! to avoid allocations.
+        //! @param begin Index of the first direction to rotate.
+        //! @param end Index past the last direction to rotate. Directions outside of the range are left unchanged.
+        static void RotateRayDirections(
+            const AZStd::vector<AZ::Vector3>& localDirections,
+            const AZ::Quaternion& rotation,
+            AZStd::vector<AZ::Vector3>& directions,
+            size_t begin = 0,
+            size_t end = AZStd::numeric_limits<size_t>::max());
     };
 } // namespace ROS2
@@ -7,16 +7,27 @@
  */
 
 #include "Lidar/ROS2LidarSensorComponent.h"
+#include "Lidar/LidarStaticScene.h"
 #include "Lidar/LidarTemplateUtils.h"
 #include "ROS2/Frame/ROS2FrameComponent.h"
 #include "ROS2/ROS2Bus.h"
+#include "ROS2/Utilities/ROS2Conversions.h"
 #include "ROS2/Utilities/ROS2Names.h"
+#include "Sensor/SensorScheduler.h"
 #include <Atom/RPI.Public/AuxGeom/AuxGeomFeatureProcessorInterface.h>
 #include <Atom/RPI.Public/RPISystemInterface.h>
 #include <Atom/RPI.Public/Scene.h>
+#include <Atom/RPI.Public/View.h>
+#include <Atom/RPI.Public/ViewportContext.h>
+#include <Atom/RPI.Public/ViewportContextBus.h>
 #include <AzCore/Component/Entity.h>
+#include <AzCore/Jobs/JobFunction.h>
+#include <AzCore/Math/Matrix4x4.h>
+#include <AzCore/Math/MathUtils.h>
 #include <AzCore/Serialization/EditContext.h>
 #include <AzCore/Serialization/EditContextConstants.inl>
+#include <AzCore/std/algorithm.h>
+#include <AzFramework/Physics/PhysicsScene.h>
 #include <AzFramework/Physics/PhysicsSystem.h>
 
 namespace ROS2
@@ -24,19 +35,28 @@ namespace ROS2
     namespace Internal
     {
         const char* kPointCloudType = "sensor_msgs::msg::PointCloud2";
+        const char* kLaserScanType = "sensor_msgs::msg::LaserScan";
     }
 
     void ROS2LidarSensorComponent::Reflect(AZ::ReflectContext* context)
     {
         LidarTemplate::Reflect(context);
+        LidarPointFilterParameters::Reflect(context);
         if (AZ::SerializeContext* serialize = azrtti_cast<AZ::SerializeContext*>(context))
         {
             serialize->Class<ROS2LidarSensorComponent, ROS2SensorComponent>()
-                ->Version(1)
-                ->Field("lidarModel", &ROS2LidarSensorComponent::m_lidarModel)
+                ->Version(8)
+                ->Field("LidarModelName", &ROS2LidarSensorComponent::m_lidarModelName)
                 ->Field("LidarParameters", &ROS2LidarSensorComponent::m_lidarParameters)
                 ->Field("IgnoreLayer", &ROS2LidarSensorComponent::m_ignoreLayer)
-                ->Field("IgnoredLayerIndex", &ROS2LidarSensorComponent::m_ignoredLayerIndex);
+                ->Field("IgnoredLayerIndex", &ROS2LidarSensorComponent::m_ignoredLayerIndex)
+                ->Field("ScanExecutionMode", &ROS2LidarSensorComponent::m_scanExecutionMode)
+                ->Field("MaxScansInFlight", &ROS2LidarSensorComponent::m_maxScansInFlight)
+                ->Field("RollingScanSlices", &ROS2LidarSensorComponent::m_rollingScanSlices)
+                ->Field("OutputMode", &ROS2LidarSensorComponent::m_outputMode)
+                ->Field("UseStaticSceneAcceleration", &ROS2LidarSensorComponent::m_useStaticSceneAcceleration)
+                ->Field("PointFilter", &ROS2LidarSensorComponent::m_pointFilterParameters)
+                ->Field("VisualisationPointBudget", &ROS2LidarSensorComponent::m_visualisationPointBudget);
 
             if (AZ::EditContext* ec = serialize->GetEditContext())
             {
@@ -44,16 +64,32 @@ namespace ROS2
                     ->ClassElement(AZ::Edit::ClassElements::EditorData, "")
                     ->Attribute(AZ::Edit::Attributes::Category, "ROS2")
                     ->Attribute(AZ::Edit::Attributes::AppearsInAddComponentMenu, AZ_CRC("Game"))
-                    ->DataElement(AZ::Edit::UIHandlers::ComboBox, &ROS2LidarSensorComponent::m_lidarModel, "Lidar Model", "Lidar model")
+                    ->DataElement(
+                        AZ::Edit::UIHandlers::ComboBox,
+                        &ROS2LidarSensorComponent::m_lidarModelName,
+                        "Lidar Model",
+                        "Lidar model. Selecting a model resets lidar parameters to its values")
+                    ->Attribute(AZ::Edit::Attributes::StringList, &LidarTemplateUtils::GetTemplateNames)
                     ->Attribute(AZ::Edit::Attributes::ChangeNotify, &ROS2LidarSensorComponent::OnLidarModelSelected)
-                    ->EnumAttribute(LidarTemplate::LidarModel::Generic3DLidar, "Generic Lidar")
-                    // TODO - show lidar template field values (read only) - see Reflect for LidarTemplate
                     ->DataElement(
                         AZ::Edit::UIHandlers::EntityId,
                         &ROS2LidarSensorComponent::m_lidarParameters,
                         "Lidar parameters",
-                        "Configuration of Generic lidar")
-                    ->Attribute(AZ::Edit::Attributes::Visibility, &ROS2LidarSensorComponent::IsConfigurationVisible)
+                        "Configuration of the lidar, initialized from the selected model")
+                    ->DataElement(
+                        AZ::Edit::UIHandlers::ComboBox,
+                        &ROS2LidarSensorComponent::m_outputMode,
+                        "Output",
+                        "Publish a point cloud, or ranges of a single horizontal layer as a laser scan")
+                    ->Attribute(AZ::Edit::Attributes::ChangeNotify, AZ::Edit::PropertyRefreshLevels::EntireTree)
+                    ->EnumAttribute(OutputMode::PointCloud, "PointCloud2")
+                    ->EnumAttribute(OutputMode::LaserScan, "LaserScan")
+                    ->DataElement(
+                        AZ::Edit::UIHandlers::Default,
+                        &ROS2LidarSensorComponent::m_pointFilterParameters,
+                        "Point filter",
+                        "Decimation, range crop and voxel grid downsampling of the point cloud before publishing")
+                    ->Attribute(AZ::Edit::Attributes::Visibility, &ROS2LidarSensorComponent::IsPointCloud)
                     ->DataElement(
                         AZ::Edit::UIHandlers::ComboBox,
                         &ROS2LidarSensorComponent::m_ignoreLayer,
@@ -63,19 +99,71 @@ namespace ROS2
                         AZ::Edit::UIHandlers::Default,
                         &ROS2LidarSensorComponent::m_ignoredLayerIndex,
                         "Ignored layer index",
-                        "Layer index to ignore");
+                        "Layer index to ignore")
+                    ->DataElement(
+                        AZ::Edit::UIHandlers::Default,
+                        &ROS2LidarSensorComponent::m_visualisationPointBudget,
+                        "Visualisation point budget",
+                        "Maximum number of points drawn when visualisation is on. Scans with more points are decimated for drawing")
+                    ->Attribute(AZ::Edit::Attributes::Min, 1)
+                    ->DataElement(
+                        AZ::Edit::UIHandlers::Default,
+                        &ROS2LidarSensorComponent::m_useStaticSceneAcceleration,
+                        "Static scene acceleration",
+                        "Resolve rays against static colliders in a hierarchy shared by all lidars, query physics for dynamic bodies only")
+                    ->DataElement(
+                        AZ::Edit::UIHandlers::ComboBox,
+                        &ROS2LidarSensorComponent::m_scanExecutionMode,
+                        "Scan execution",
+                        "Execute scans on the main thread, asynchronously in jobs or as rolling slices on physics substeps")
+                    ->Attribute(AZ::Edit::Attributes::ChangeNotify, AZ::Edit::PropertyRefreshLevels::EntireTree)
+                    ->EnumAttribute(ScanExecutionMode::Synchronous, "Synchronous")
+                    ->EnumAttribute(ScanExecutionMode::Asynchronous, "Asynchronous")
+                    ->EnumAttribute(ScanExecutionMode::RollingScan, "Rolling scan")
+                    ->DataElement(
+                        AZ::Edit::UIHandlers::Default,
+                        &ROS2LidarSensorComponent::m_maxScansInFlight,
+                        "Max scans in flight",
+                        "Maximum number of asynchronous scans processed at the same time. Scans above this limit are dropped")
+                    ->Attribute(AZ::Edit::Attributes::Min, 1)
+                    ->Attribute(AZ::Edit::Attributes::Max, 8)
+                    ->Attribute(AZ::Edit::Attributes::Visibility, &ROS2LidarSensorComponent::IsAsynchronous)
+                    ->DataElement(
+                        AZ::Edit::UIHandlers::Default,
+                        &ROS2LidarSensorComponent::m_rollingScanSlices,
+                        "Rolling scan slices",
+                        "Number of azimuth slices in a revolution. At most one slice per physics substep follows the lidar motion")
+                    ->Attribute(AZ::Edit::Attributes::Min, 1)
+                    ->Attribute(AZ::Edit::Attributes::Max, 360)
+                    ->Attribute(AZ::Edit::Attributes::Visibility, &ROS2LidarSensorComponent::IsRollingScan);
             }
         }
     }
 
-    bool ROS2LidarSensorComponent::IsConfigurationVisible() const
+    bool ROS2LidarSensorComponent::IsAsynchronous() const
+    {
+        return m_scanExecutionMode == ScanExecutionMode::Asynchronous;
+    }
+
+    bool ROS2LidarSensorComponent::IsRollingScan() const
+    {
+        return m_scanExecutionMode == ScanExecutionMode::RollingScan;
+    }
+
+    bool ROS2LidarSensorComponent::IsLaserScan() const
     {
-        return m_lidarModel == LidarTemplate::Generic3DLidar;
+        return m_outputMode == OutputMode::LaserScan;
+    }
+
+    bool ROS2LidarSensorComponent::IsPointCloud() const
+    {
+        return m_outputMode == OutputMode::PointCloud;
     }
 
     AZ::Crc32 ROS2LidarSensorComponent::OnLidarModelSelected()
     {
-        m_lidarParameters = LidarTemplateUtils::GetTemplate(m_lidarModel);
+        m_lidarParameters = LidarTemplateUtils::GetTemplate(m_lidarModelName);
+        UpdateRayDirections();
         return AZ::Edit::PropertyRefreshLevels::EntireTree;
     }
 
@@ -87,126 +175,519 @@ namespace ROS2
         pc.m_topic = "pc";
         m_sensorConfiguration.m_frequency = 10; // TODO - dependent on lidar type
         m_sensorConfiguration.m_publishersConfigurations.insert(AZStd::make_pair(type, pc));
+
+        TopicConfiguration ls;
+        ls.m_type = Internal::kLaserScanType;
+        ls.m_topic = "scan";
+        m_sensorConfiguration.m_publishersConfigurations.insert(AZStd::make_pair(ls.m_type, ls));
+    }
+
+    LidarTemplate ROS2LidarSensorComponent::GetScanTemplate() const
+    {
+        if (!IsLaserScan())
+        {
+            return m_lidarParameters;
+        }
+
+        LidarTemplate planarTemplate = m_lidarParameters;
+        planarTemplate.m_layers = 1;
+        planarTemplate.m_minVAngle = 0.0f;
+        planarTemplate.m_maxVAngle = 0.0f;
+        planarTemplate.m_beamElevations.clear();
+        planarTemplate.m_beamAzimuthOffsets.clear();
+        return planarTemplate;
+    }
+
+    void ROS2LidarSensorComponent::UpdateRayDirections()
+    {
+        const LidarTemplate scanTemplate = GetScanTemplate();
+        const float scanDuration = m_sensorConfiguration.m_frequency > 0.0f ? 1.0f / m_sensorConfiguration.m_frequency : 0.0f;
+        m_lidarRayDirections = LidarTemplateUtils::PopulateRayDirections(scanTemplate);
+        m_lidarRayRings = LidarTemplateUtils::PopulateRayRings(scanTemplate);
+        m_lidarRayTimeOffsets = LidarTemplateUtils::PopulateRayTimeOffsets(scanTemplate, scanDuration);
+        m_scanColumnCount = scanTemplate.m_numberOfIncrements;
+        if (IsPointCloud())
+        { // Rays of skipped rings and columns are not cast at all
+            m_scanColumnCount = LidarPointFilter::DecimateRays(
+                m_pointFilterParameters, scanTemplate.m_layers, m_lidarRayDirections, m_lidarRayRings, m_lidarRayTimeOffsets);
+        }
     }
 
     void ROS2LidarSensorComponent::Visualise()
     {
-        if (m_visualisationPoints.empty())
+        if (!m_drawQueue)
+        {
+            return;
+        }
+
+        auto* viewportContextManager = AZ::Interface<AZ::RPI::ViewportContextRequestsInterface>::Get();
+        auto viewportContext = viewportContextManager ? viewportContextManager->GetDefaultViewportContext() : nullptr;
+        if (!viewportContext)
         {
             return;
         }
 
-        if (m_drawQueue)
+        AZStd::lock_guard<AZStd::mutex> lock(m_visualisationMutex);
+        if (m_visualisationPoints.empty())
         {
-            const uint8_t pixelSize = 2;
-            AZ::RPI::AuxGeomDraw::AuxGeomDynamicDrawArguments drawArgs;
-            drawArgs.m_verts = m_visualisationPoints.data();
-            drawArgs.m_vertCount = m_visualisationPoints.size();
-            drawArgs.m_colors = &AZ::Colors::Red;
-            drawArgs.m_colorCount = 1;
-            drawArgs.m_opacityType = AZ::RPI::AuxGeomDraw::OpacityType::Opaque;
-            drawArgs.m_size = pixelSize;
-            m_drawQueue->DrawPoints(drawArgs);
+            return;
         }
+
+        // Points stay in the lidar frame, the lidar pose is applied as a part of the view projection on the GPU
+        const AZ::Matrix4x4 lidarToClip = viewportContext->GetDefaultView()->GetWorldToClipMatrix() *
+            AZ::Matrix4x4::CreateFromTransform(m_visualisationTransform);
+        const uint8_t pixelSize = 2;
+        AZ::RPI::AuxGeomDraw::AuxGeomDynamicDrawArguments drawArgs;
+        drawArgs.m_verts = m_visualisationPoints.data();
+        drawArgs.m_vertCount = m_visualisationPoints.size();
+        drawArgs.m_colors = &AZ::Colors::Red;
+        drawArgs.m_colorCount = 1;
+        drawArgs.m_opacityType = AZ::RPI::AuxGeomDraw::OpacityType::Opaque;
+        drawArgs.m_size = pixelSize;
+        drawArgs.m_viewProjectionOverrideIndex = m_drawQueue->AddViewProjOverride(lidarToClip);
+        m_drawQueue->DrawPoints(drawArgs);
     }
 
-    void ROS2LidarSensorComponent::SetPhysicsScene()
+    void ROS2LidarSensorComponent::StoreVisualisationPoints(ScanSlot& slot, const AZ::Transform& lidarTransform)
     {
-        auto* physicsSystem = AZ::Interface<AzPhysics::SystemInterface>::Get();
-        auto foundBody = physicsSystem->FindAttachedBodyHandleFromEntityId(GetEntityId());
-        auto lidarPhysicsSceneHandle = foundBody.first;
-        if (foundBody.first == AzPhysics::InvalidSceneHandle)
+        AZStd::lock_guard<AZStd::mutex> lock(m_visualisationMutex);
+        m_visualisationTransform = lidarTransform;
+        m_visualisationPoints.clear(); // Capacity for the point budget is reserved on activation
+        const size_t pointBudget = AZStd::max(m_visualisationPointBudget, 1u);
+        if (IsLaserScan())
         {
-            auto* sceneInterface = AZ::Interface<AzPhysics::SceneInterface>::Get();
-            lidarPhysicsSceneHandle = sceneInterface->GetSceneHandle(AzPhysics::DefaultPhysicsSceneName);
+            const auto& ranges = slot.m_laserScan.ranges;
+            const size_t stride = (ranges.size() + pointBudget - 1) / pointBudget;
+            for (size_t i = 0; i < ranges.size(); i += stride)
+            {
+                if (ranges[i] <= slot.m_laserScan.range_max)
+                {
+                    m_visualisationPoints.push_back(m_lidarRayDirections[i] * ranges[i]);
+                }
+            }
+            return;
         }
 
-        AZ_Assert(lidarPhysicsSceneHandle != AzPhysics::InvalidSceneHandle, "Invalid physics scene handle for entity");
-        m_lidarRaycaster.SetRaycasterScene(lidarPhysicsSceneHandle);
+        const size_t pointCount = slot.m_pointCloud.GetPointCount();
+        const size_t stride = (pointCount + pointBudget - 1) / pointBudget;
+        for (size_t i = 0; i < pointCount; i += stride)
+        {
+            m_visualisationPoints.push_back(slot.m_pointCloud.GetPointPosition(i));
+        }
+    }
+
+    void ROS2LidarSensorComponent::CreateScanSlots()
+    {
+        const auto physicsScene = GetPhysicsScene();
+        const float scanDuration = m_sensorConfiguration.m_frequency > 0.0f ? 1.0f / m_sensorConfiguration.m_frequency : 0.0f;
+        const LidarTemplate scanTemplate = GetScanTemplate();
+        const size_t rayCount = m_lidarRayDirections.size();
+        const unsigned int slotCount = IsAsynchronous() ? AZStd::max(m_maxScansInFlight, 1u) : 1;
+        m_scanSlots.clear();
+        for (unsigned int i = 0; i < slotCount; i++)
+        {
+            auto slot = AZStd::make_unique<ScanSlot>();
+            slot->m_raycaster.SetRaycasterScene(physicsScene);
+            slot->m_raycaster.SetAddPointsMaxRange(m_lidarParameters.m_addPointsAtMax);
+            slot->m_raycaster.SetRange(m_lidarParameters.m_maxRange);
+            slot->m_raycaster.SetIgnoredLayer(m_ignoreLayer, m_ignoredLayerIndex);
+            slot->m_raycaster.SetNoise(m_lidarParameters.m_noiseParameters, static_cast<AZ::u64>(GetEntityId()));
+            slot->m_raycaster.SetRayDirections(m_lidarRayDirections);
+            slot->m_raycaster.SetRayAttributes(m_lidarRayRings, m_lidarRayTimeOffsets);
+            slot->m_pointCloud.Configure(IsLaserScan() ? 0 : rayCount, m_lidarParameters.m_pointFormat);
+            slot->m_pointFilter.Configure(IsLaserScan() ? LidarPointFilterParameters{} : m_pointFilterParameters, rayCount);
+            if (IsLaserScan())
+            { // Ranges are written in place, so the message only needs to be sized once
+                auto& laserScan = slot->m_laserScan;
+                const float angleIncrement = scanTemplate.m_numberOfIncrements > 0
+                    ? AZ::DegToRad(scanTemplate.m_maxHAngle - scanTemplate.m_minHAngle) / scanTemplate.m_numberOfIncrements
+                    : 0.0f;
+                laserScan.angle_min = AZ::DegToRad(scanTemplate.m_minHAngle);
+                laserScan.angle_max = laserScan.angle_min + angleIncrement * (rayCount > 0 ? rayCount - 1 : 0);
+                laserScan.angle_increment = angleIncrement;
+                laserScan.scan_time = scanDuration;
+                laserScan.time_increment = rayCount > 0 ? scanDuration / rayCount : 0.0f;
+                laserScan.range_min = 0.0f;
+                laserScan.range_max = scanTemplate.m_maxRange;
+                laserScan.ranges.resize(rayCount);
+                laserScan.intensities.resize(scanTemplate.m_pointFormat != LidarTemplate::PointXYZ ? rayCount : 0);
+            }
+            m_scanSlots.emplace_back(AZStd::move(slot));
+        }
     }
 
     void ROS2LidarSensorComponent::Activate()
     {
-        auto ros2Node = ROS2Interface::Get()->GetNode();
-        AZ_Assert(m_sensorConfiguration.m_publishersConfigurations.size() == 1, "Invalid configuration of publishers for lidar sensor");
+        auto ros2Node = GetNamespaceNode();
+        const char* publisherType = IsLaserScan() ? Internal::kLaserScanType : Internal::kPointCloudType;
+        auto publisherConfigIt = m_sensorConfiguration.m_publishersConfigurations.find(publisherType);
+        if (publisherConfigIt == m_sensorConfiguration.m_publishersConfigurations.end())
+        { // Configurations saved before laser scan output was available have no laser scan publisher
+            TopicConfiguration defaultConfig;
+            defaultConfig.m_type = Internal::kLaserScanType;
+            defaultConfig.m_topic = "scan";
+            publisherConfigIt =
+                m_sensorConfiguration.m_publishersConfigurations.insert(AZStd::make_pair(defaultConfig.m_type, defaultConfig)).first;
+        }
 
-        const TopicConfiguration& publisherConfig = m_sensorConfiguration.m_publishersConfigurations[Internal::kPointCloudType];
+        const TopicConfiguration& publisherConfig = publisherConfigIt->second;
         AZStd::string fullTopic = ROS2Names::GetNamespacedName(GetNamespace(), publisherConfig.m_topic);
-        m_pointCloudPublisher = ros2Node->create_publisher<sensor_msgs::msg::PointCloud2>(fullTopic.data(), publisherConfig.GetQoS());
+        if (IsLaserScan())
+        {
+            m_laserScanPublisher = ros2Node->create_publisher<sensor_msgs::msg::LaserScan>(fullTopic.data(), publisherConfig.GetQoS());
+        }
+        else
+        {
+            m_pointCloudPublisher = ros2Node->create_publisher<sensor_msgs::msg::PointCloud2>(fullTopic.data(), publisherConfig.GetQoS());
+        }
 
-        SetPhysicsScene();
+        UpdateRayDirections();
         if (m_sensorConfiguration.m_visualise)
         {
             auto* entityScene = AZ::RPI::Scene::GetSceneForEntityId(GetEntityId());
             m_drawQueue = AZ::RPI::AuxGeomFeatureProcessorInterface::GetDrawQueueForScene(entityScene);
+            m_visualisationPoints.reserve(AZStd::min(m_lidarRayDirections.size(), size_t{ AZStd::max(m_visualisationPointBudget, 1u) }));
+        }
+        CreateScanSlots();
+        m_droppedScans = 0;
+        m_nextScanSequence = 0;
+        m_nextPublishedSequence = 0;
+
+        if (IsRollingScan())
+        {
+            m_hasPreviousSubstepTransform = false;
+            m_revolutionTime = 0.0f;
+            m_castSlices = 0;
+            m_substepPhysicsScene = GetPhysicsScene();
+            if (auto* sensorScheduler = SensorSchedulerInterface::Get())
+            {
+                m_substepSensorId = sensorScheduler->AddStepSensor(
+                    m_substepPhysicsScene,
+                    [this](double substepEndTime, double substepDuration)
+                    {
+                        OnPhysicsSubstep(substepEndTime, substepDuration);
+                    });
+            }
         }
-        m_lidarRaycaster.SetAddPointsMaxRange(m_lidarParameters.m_addPointsAtMax);
         ROS2SensorComponent::Activate();
     }
 
     void ROS2LidarSensorComponent::Deactivate()
     {
         ROS2SensorComponent::Deactivate();
+        if (auto* sensorScheduler = SensorSchedulerInterface::Get();
+            sensorScheduler && m_substepSensorId != SensorSchedule::InvalidSensorId)
+        {
+            sensorScheduler->RemoveSensor(m_substepPhysicsScene, m_substepSensorId);
+        }
+        m_substepSensorId = SensorSchedule::InvalidSensorId;
+        if (auto* lidarSystem = LidarSystemInterface::Get())
+        {
+            lidarSystem->CancelScans(this);
+        }
+        m_isBatchedScanPending = false;
+        if (IsAsynchronous())
+        { // Scan jobs use slots and the publisher, wait for them to finish
+            m_scanJobsCompletion.StartAndWaitForCompletion();
+            m_scanJobsCompletion.Reset(true);
+        }
+        AZ_TracePrintf("Lidar Sensor Component", "Dropped %zu scans while previous scans were still being processed\n", m_droppedScans);
+
+        if (IsPointCloud() && m_pointFilterParameters.IsPointFilteringEnabled())
+        {
+            const LidarPointFilter::Statistics statistics = GetPointFilterStatistics();
+            AZ_TracePrintf(
+                "Lidar Sensor Component",
+                "Point filter reduced %zu points to %zu before publishing\n",
+                statistics.m_totalInputPointCount,
+                statistics.m_totalOutputPointCount);
+        }
+        m_scanSlots.clear();
         m_pointCloudPublisher.reset();
+        m_laserScanPublisher.reset();
+    }
+
+    LidarPointFilter::Statistics ROS2LidarSensorComponent::GetPointFilterStatistics() const
+    {
+        // Asynchronous scans are filtered while publishing, which is guarded by the mutex
+        AZStd::lock_guard<AZStd::mutex> lock(m_publishMutex);
+        LidarPointFilter::Statistics statistics;
+        const ScanSlot* lastPublishedSlot = nullptr;
+        for (const auto& slot : m_scanSlots)
+        {
+            const LidarPointFilter::Statistics& slotStatistics = slot->m_pointFilter.GetStatistics();
+            statistics.m_totalInputPointCount += slotStatistics.m_totalInputPointCount;
+            statistics.m_totalOutputPointCount += slotStatistics.m_totalOutputPointCount;
+            if (!slot->m_inFlight && slotStatistics.m_totalInputPointCount > 0 &&
+                (!lastPublishedSlot || slot->m_sequence > lastPublishedSlot->m_sequence))
+            {
+                lastPublishedSlot = slot.get();
+            }
+        }
+        if (lastPublishedSlot)
+        {
+            statistics.m_lastInputPointCount = lastPublishedSlot->m_pointFilter.GetStatistics().m_lastInputPointCount;
+            statistics.m_lastOutputPointCount = lastPublishedSlot->m_pointFilter.GetStatistics().m_lastOutputPointCount;
+        }
+        return statistics;
     }
 
     void ROS2LidarSensorComponent::FrequencyTick()
     {
-        float distance = m_lidarParameters.m_maxRange;
+        if (IsRollingScan())
+        { // Slices are cast on physics substeps instead
+            return;
+        }
+
         auto entityTransform = GetEntity()->FindComponent<AzFramework::TransformComponent>(); // TODO - go through ROS2Frame
-        const auto directions =
-            LidarTemplateUtils::PopulateRayDirections(m_lidarParameters, entityTransform->GetWorldTM().GetEulerRadians());
-        AZ::Vector3 start = entityTransform->GetWorldTM().GetTranslation();
-        start.SetZ(start.GetZ());
+        auto* ros2Frame = Utils::GetGameOrEditorComponent<ROS2FrameComponent>(GetEntity());
 
-        auto worldToLidarTransform = entityTransform->GetWorldTM();
-        worldToLidarTransform.Invert();
+        // Pose and timestamp are snapshotted here, so that asynchronous scans describe the moment they were due
+        const AZ::Transform lidarTransform = entityTransform->GetWorldTM();
+        std_msgs::msg::Header header;
+        header.frame_id = ros2Frame->GetFrameID().data();
+        header.stamp = GetSampleTimestamp();
 
-        m_lastScanResults =
-            m_lidarRaycaster.PerformRaycast(start, directions, worldToLidarTransform, distance, m_ignoreLayer, m_ignoredLayerIndex);
-        if (m_lastScanResults.empty())
+        if (!IsAsynchronous())
         {
-            AZ_TracePrintf("Lidar Sensor Component", "No results from raycast\n");
+            auto* lidarSystem = LidarSystemInterface::Get();
+            if (!lidarSystem)
+            {
+                PrepareScan(*m_scanSlots.front());
+                ProcessScan(*m_scanSlots.front(), lidarTransform, header);
+                return;
+            }
+
+            // Cast at the end of the frame with scans of other lidars. A scan deferred by the ray budget is replaced with this one
+            m_batchedScanTransform = lidarTransform;
+            m_batchedScanHeader = header;
+            if (m_isBatchedScanPending)
+            {
+                m_droppedScans++;
+                return;
+            }
+            m_isBatchedScanPending = true;
+            lidarSystem->SubmitScan(this);
             return;
         }
 
-        if (m_sensorConfiguration.m_visualise)
-        { // Store points for visualisation purposes, in global frame
-            auto localToWorldTM = entityTransform->GetWorldTM();
+        auto freeSlot = AZStd::find_if(
+            m_scanSlots.begin(),
+            m_scanSlots.end(),
+            [](const AZStd::unique_ptr<ScanSlot>& slot)
+            {
+                return !slot->m_inFlight;
+            });
+        if (freeSlot == m_scanSlots.end())
+        { // Drop the newest scan, scans in flight already describe older poses and will be published first
+            m_droppedScans++;
+            return;
+        }
 
-            // TODO - improve performance
-            m_visualisationPoints = m_lastScanResults;
-            for (AZ::Vector3& point : m_visualisationPoints)
+        ScanSlot* slot = freeSlot->get();
+        PrepareScan(*slot);
+        slot->m_transform = lidarTransform;
+        slot->m_header = header;
+        slot->m_inFlight = true;
+        AZ::Job* scanJob = AZ::CreateJobFunction(
+            [this, slot]()
             {
-                point = localToWorldTM.TransformPoint(point);
+                slot->m_pointCloud.BeginScan();
+                CastRays(*slot, slot->m_transform);
+                slot->m_pointCloud.EndScan();
+                PublishScansInOrder(*slot);
+            },
+            true);
+        scanJob->SetDependent(&m_scanJobsCompletion);
+        scanJob->Start();
+    }
+
+    void ROS2LidarSensorComponent::PublishScansInOrder(ScanSlot& castSlot)
+    {
+        AZStd::lock_guard<AZStd::mutex> lock(m_publishMutex);
+        castSlot.m_isCastFinished = true;
+        while (true)
+        {
+            auto nextSlot = AZStd::find_if(
+                m_scanSlots.begin(),
+                m_scanSlots.end(),
+                [this](const AZStd::unique_ptr<ScanSlot>& slot)
+                {
+                    return slot->m_inFlight && slot->m_isCastFinished && slot->m_sequence == m_nextPublishedSequence;
+                });
+            if (nextSlot == m_scanSlots.end())
+            { // The next scan is still being cast, its job publishes scans cast meanwhile
+                return;
             }
+
+            ScanSlot& slot = **nextSlot;
+            PublishScan(slot, slot.m_transform, slot.m_header);
+            slot.m_isCastFinished = false;
+            m_nextPublishedSequence++;
+            slot.m_inFlight = false;
         }
+    }
 
-        auto* ros2Frame = Utils::GetGameOrEditorComponent<ROS2FrameComponent>(GetEntity());
-        auto message = sensor_msgs::msg::PointCloud2();
-        message.header.frame_id = ros2Frame->GetFrameID().data();
-        message.header.stamp = ROS2Interface::Get()->GetROSTimestamp();
-        message.height = 1;
-        message.width = m_lastScanResults.size();
-        message.point_step = sizeof(AZ::Vector3); // TODO - Point Fields can be custom
-        message.row_step = message.width * message.point_step;
-
-        // TODO - a list of supported fields should be returned by lidar implementation
-        std::vector<std::string> point_field_names = { "x", "y", "z" };
-        for (int i = 0; i < point_field_names.size(); i++)
-        { // TODO - placeholder impl
-            sensor_msgs::msg::PointField pf;
-            pf.name = point_field_names[i];
-            pf.offset = i * 4;
-            pf.datatype = sensor_msgs::msg::PointField::FLOAT32;
-            pf.count = 1;
-            message.fields.push_back(pf);
-        }
-
-        size_t sizeInBytes = m_lastScanResults.size() * sizeof(AZ::Vector3);
-        message.data.resize(sizeInBytes);
-        AZ_Assert(message.row_step * message.height == sizeInBytes, "Inconsistency in the size of point cloud data");
-        memcpy(message.data.data(), m_lastScanResults.data(), sizeInBytes);
+    void ROS2LidarSensorComponent::PrepareScan(ScanSlot& slot)
+    {
+        // Noise follows the scans of the sensor, not of the slot, so that it does not repeat between slots
+        slot.m_sequence = m_nextScanSequence++;
+        slot.m_raycaster.SetNoiseScanIndex(slot.m_sequence);
+        if (m_useStaticSceneAcceleration)
+        { // Scans in flight keep the scene they started with, even if it is rebuilt meanwhile
+            slot.m_raycaster.SetStaticScene(LidarStaticScene::Get(GetPhysicsScene()));
+        }
+    }
+
+    size_t ROS2LidarSensorComponent::GetBatchedScanRayCount() const
+    {
+        return m_lidarRayDirections.size();
+    }
+
+    LidarRaycaster* ROS2LidarSensorComponent::PrepareBatchedScan()
+    {
+        ScanSlot& slot = *m_scanSlots.front();
+        PrepareScan(slot);
+        if (!slot.m_raycaster.PrepareRaycast(m_batchedScanTransform))
+        {
+            m_isBatchedScanPending = false;
+            return nullptr;
+        }
+        return &slot.m_raycaster;
+    }
+
+    void ROS2LidarSensorComponent::FinishBatchedScan()
+    {
+        m_isBatchedScanPending = false;
+        ScanSlot& slot = *m_scanSlots.front();
+        slot.m_pointCloud.BeginScan();
+        WriteResults(slot);
+        slot.m_pointCloud.EndScan();
+        PublishScan(slot, m_batchedScanTransform, m_batchedScanHeader);
+    }
+
+    void ROS2LidarSensorComponent::WriteResults(ScanSlot& slot)
+    {
+        if (IsLaserScan())
+        {
+            slot.m_raycaster.WriteResults(slot.m_laserScan);
+        }
+        else
+        {
+            slot.m_raycaster.WriteResults(slot.m_pointCloud);
+        }
+    }
+
+    void ROS2LidarSensorComponent::ProcessScan(ScanSlot& slot, const AZ::Transform& lidarTransform, const std_msgs::msg::Header& header)
+    {
+        slot.m_pointCloud.BeginScan();
+        CastRays(slot, lidarTransform);
+        slot.m_pointCloud.EndScan();
+        PublishScan(slot, lidarTransform, header);
+    }
+
+    void ROS2LidarSensorComponent::CastRays(ScanSlot& slot, const AZ::Transform& lidarTransform, size_t rayBegin, size_t rayEnd)
+    {
+        if (IsLaserScan())
+        {
+            slot.m_raycaster.PerformRaycast(lidarTransform, slot.m_laserScan, rayBegin, rayEnd);
+        }
+        else
+        {
+            slot.m_raycaster.PerformRaycast(lidarTransform, slot.m_pointCloud, rayBegin, rayEnd);
+        }
+    }
+
+    void ROS2LidarSensorComponent::OnPhysicsSubstep(double substepEndTime, double substepDuration)
+    {
+        if (m_sensorConfiguration.m_frequency <= 0.0f || m_scanSlots.empty() || m_lidarRayDirections.empty())
+        {
+            return;
+        }
+
+        // Transforms of simulated bodies are already updated for the finished substep
+        auto entityTransform = GetEntity()->FindComponent<AzFramework::TransformComponent>();
+        const AZ::Transform currentTransform = entityTransform->GetWorldTM();
+        if (!m_hasPreviousSubstepTransform)
+        {
+            m_previousSubstepTransform = currentTransform;
+            m_hasPreviousSubstepTransform = true;
+        }
+
+        ScanSlot& slot = *m_scanSlots.front();
+        const float scanDuration = 1.0f / m_sensorConfiguration.m_frequency;
+        const unsigned int sliceCount = AZStd::clamp(m_rollingScanSlices, 1u, AZStd::max(m_scanColumnCount, 1u));
+        const auto fixedDeltaTime = static_cast<float>(substepDuration);
+        float substepStartTime = m_revolutionTime; // Relative to the start of the revolution, as slice times
+        const double substepStartStamp = substepEndTime - substepDuration;
+        m_revolutionTime += fixedDeltaTime;
+
+        // Slices are contiguous ranges of rays, since rays are ordered by increment (azimuth) first
+        const size_t raysPerIncrement = m_scanColumnCount > 0 ? m_lidarRayDirections.size() / m_scanColumnCount : 0;
+        for (float sliceTime = m_castSlices * scanDuration / sliceCount; sliceTime <= m_revolutionTime;
+             sliceTime = m_castSlices * scanDuration / sliceCount)
+        {
+            if (m_castSlices == 0)
+            {
+                auto* ros2Frame = Utils::GetGameOrEditorComponent<ROS2FrameComponent>(GetEntity());
+                m_revolutionHeader.frame_id = ros2Frame->GetFrameID().data();
+                // Firing time of the first slice, which point times are relative to
+                m_revolutionHeader.stamp = ROS2Conversions::ToROS2Time(substepStartStamp + (sliceTime - substepStartTime));
+                PrepareScan(slot);
+                slot.m_pointCloud.BeginScan();
+            }
+
+            const float t = fixedDeltaTime > 0.0f ? AZ::GetClamp((sliceTime - substepStartTime) / fixedDeltaTime, 0.0f, 1.0f) : 1.0f;
+            const AZ::Transform sliceTransform(
+                m_previousSubstepTransform.GetTranslation().Lerp(currentTransform.GetTranslation(), t),
+                m_previousSubstepTransform.GetRotation().Slerp(currentTransform.GetRotation(), t),
+                currentTransform.GetUniformScale());
+
+            const size_t firstIncrement = size_t{ m_scanColumnCount } * m_castSlices / sliceCount;
+            const size_t lastIncrement = size_t{ m_scanColumnCount } * (m_castSlices + 1) / sliceCount;
+            CastRays(slot, sliceTransform, firstIncrement * raysPerIncrement, lastIncrement * raysPerIncrement);
+
+            m_castSlices++;
+            if (m_castSlices == sliceCount)
+            { // Points of each slice are in the lidar frame of their own firing time, as with a real rotating lidar
+                slot.m_pointCloud.EndScan();
+                PublishScan(slot, currentTransform, m_revolutionHeader);
+                m_castSlices = 0;
+                m_revolutionTime -= scanDuration;
+                substepStartTime -= scanDuration; // Slices of the next revolution in this substep are interpolated from it
+            }
+        }
+        m_previousSubstepTransform = currentTransform;
+    }
+
+    void ROS2LidarSensorComponent::PublishScan(ScanSlot& slot, const AZ::Transform& lidarTransform, const std_msgs::msg::Header& header)
+    {
+        if (IsLaserScan())
+        {
+            if (m_sensorConfiguration.m_visualise)
+            {
+                StoreVisualisationPoints(slot, lidarTransform);
+            }
+
+            slot.m_laserScan.header = header;
+            m_laserScanPublisher->publish(slot.m_laserScan);
+            return;
+        }
+
+        const size_t pointCount = slot.m_pointFilter.Apply(slot.m_pointCloud);
+        if (pointCount == 0)
+        {
+            AZ_TracePrintf("Lidar Sensor Component", "No results from raycast\n");
+            return;
+        }
+
+        if (m_sensorConfiguration.m_visualise)
+        {
+            StoreVisualisationPoints(slot, lidarTransform);
+        }
+
+        auto& message = slot.m_pointCloud.GetMessage();
+        message.header = header;
         m_pointCloudPublisher->publish(message);
     }
 } // namespace ROS2
@@ -7,14 +7,24 @@
  */
 #pragma once
 
+#include "Lidar/LidarPointCloud.h"
+#include "Lidar/LidarPointFilter.h"
 #include "Lidar/LidarRaycaster.h"
+#include "Lidar/LidarSystemBus.h"
 #include "Lidar/LidarTemplate.h"
 #include "Lidar/LidarTemplateUtils.h"
 #include "ROS2/Sensor/ROS2SensorComponent.h"
 #include <Atom/RPI.Public/AuxGeom/AuxGeomDraw.h>
+#include <AzCore/Jobs/JobCompletion.h>
 #include <AzCore/Serialization/SerializeContext.h>
+#include <AzCore/std/parallel/atomic.h>
+#include <AzCore/std/parallel/mutex.h>
+#include <AzCore/std/smart_ptr/unique_ptr.h>
+#include <AzFramework/Physics/Common/PhysicsTypes.h>
 #include <rclcpp/publisher.hpp>
+#include <sensor_msgs/msg/laser_scan.hpp>
 #include <sensor_msgs/msg/point_cloud2.hpp>
+#include <std_msgs/msg/header.hpp>
 
 namespace ROS2
 {
@@ -23,7 +33,9 @@ namespace ROS2
     //! Lidar Component allows customization of lidar type and behavior and encapsulates both simulation.
     //! and data publishing. Lidar Component requires ROS2FrameComponent.
     // TODO - Add selection of implementation choice (PhysX, GPU, other), noise
-    class ROS2LidarSensorComponent : public ROS2SensorComponent
+    class ROS2LidarSensorComponent
+        : public ROS2SensorComponent
+        , protected LidarBatchClient
     {
     public:
         AZ_COMPONENT(ROS2LidarSensorComponent, "{502A955F-7742-4E23-AD77-5E4063739DCA}", ROS2SensorComponent);
@@ -33,27 +45,135 @@ namespace ROS2
         void Activate() override;
         void Deactivate() override;
 
+        //! Where the scan (raycasting, transformation and publishing) is executed.
+        enum ScanExecutionMode
+        {
+            Synchronous, //!< Scan is executed on the main thread at the end of the frame, batched with scans of other lidars.
+            Asynchronous, //!< Scan is executed as a job, pose and timestamp are taken in the sensor tick.
+            RollingScan //!< Revolution is cast in azimuth slices on physics substeps, so that motion during the scan distorts it.
+        };
+
+        //! Message type the scan is published as.
+        enum OutputMode
+        {
+            PointCloud, //!< sensor_msgs/PointCloud2 with points in the configured format.
+            LaserScan //!< sensor_msgs/LaserScan with ranges of a single layer, for planar lidars.
+        };
+
+        //! Point filter statistics of the component, such as to monitor filtering while simulating. Call from the main thread.
+        //! @return Totals summed over the scan slots, last counts of the most recently published scan; zeros when the component
+        //! is not active.
+        LidarPointFilter::Statistics GetPointFilterStatistics() const;
+
     private:
+        //! Resources of a single scan. They are reused between scans; asynchronous mode holds one per scan in flight.
+        struct ScanSlot
+        {
+            LidarRaycaster m_raycaster;
+            LidarPointCloud m_pointCloud; //!< Message with the field layout set on activation, raycaster writes into it.
+            sensor_msgs::msg::LaserScan m_laserScan; //!< Used instead of the point cloud in laser scan output mode.
+            LidarPointFilter m_pointFilter; //!< Applied to the point cloud before publishing.
+            AZStd::atomic_bool m_inFlight{ false };
+            // Scan in flight, set before it is started. Asynchronous scans are published in the order of their sequence numbers
+            AZ::u64 m_sequence = 0;
+            AZ::Transform m_transform = AZ::Transform::CreateIdentity();
+            std_msgs::msg::Header m_header;
+            bool m_isCastFinished = false; //!< Guarded by m_publishMutex.
+        };
+
         void FrequencyTick() override;
         void Visualise() override;
-        void SetPhysicsScene();
+        //! Compute ray tables of a scan. Rays of rings and columns skipped by the point filter are removed.
+        void UpdateRayDirections();
+        void CreateScanSlots();
+
+        //! Lidar parameters used for scanning. In laser scan mode, this is a single horizontal layer.
+        LidarTemplate GetScanTemplate() const;
+
+        ////////////////////////////////////////////////////////////////////////
+        // LidarBatchClient interface implementation
+        size_t GetBatchedScanRayCount() const override;
+        LidarRaycaster* PrepareBatchedScan() override;
+        void FinishBatchedScan() override;
+        ////////////////////////////////////////////////////////////////////////
+
+        //! Write results of a completed raycast into the output message of a slot.
+        void WriteResults(ScanSlot& slot);
+
+        //! Cast a range of rays into the output message of a slot.
+        void CastRays(ScanSlot& slot, const AZ::Transform& lidarTransform, size_t rayBegin = 0, size_t rayEnd = LidarRaycaster::AllRays);
+
+        //! Raycast, publish and store points for visualisation, on the main thread.
+        void ProcessScan(ScanSlot& slot, const AZ::Transform& lidarTransform, const std_msgs::msg::Header& header);
+
+        //! Store points of a finished scan in the lidar frame for drawing, decimated to the visualisation point budget.
+        void StoreVisualisationPoints(ScanSlot& slot, const AZ::Transform& lidarTransform);
+
+        //! Publish a finished scan and store its points for visualisation.
+        void PublishScan(ScanSlot& slot, const AZ::Transform& lidarTransform, const std_msgs::msg::Header& header);
+
+        //! Mark an asynchronous scan as cast, and publish it and scans cast after it once all earlier scans are published.
+        //! Called from scan jobs, which can finish in any order.
+        void PublishScansInOrder(ScanSlot& castSlot);
+
+        //! Cast slices of the rolling scan which are due in the physics substep that has just finished.
+        //! Each slice is cast from the lidar pose interpolated to its firing time.
+        //! @param substepEndTime - end of the substep on the ROS clock, as mapped by the sensor scheduler for all sensors [s]
+        //! @param substepDuration - simulation time of the substep [s]
+        void OnPhysicsSubstep(double substepEndTime, double substepDuration);
 
         AZ::Crc32 OnLidarModelSelected();
-        bool IsConfigurationVisible() const;
+        bool IsAsynchronous() const;
+        bool IsRollingScan() const;
+        //! Give the slot the sequence number of a new scan, its noise and the current static scene of the physics scene.
+        //! Call from the main thread, before casting a scan.
+        void PrepareScan(ScanSlot& slot);
+        bool IsLaserScan() const;
+        bool IsPointCloud() const;
 
-        LidarTemplate::LidarModel m_lidarModel = LidarTemplate::Generic3DLidar;
+        AZStd::string m_lidarModelName = LidarTemplateUtils::GenericLidarName; //!< One of LidarTemplateUtils::GetTemplateNames.
         LidarTemplate m_lidarParameters = LidarTemplateUtils::GetTemplate(LidarTemplate::Generic3DLidar);
-        LidarRaycaster m_lidarRaycaster;
+        AZStd::vector<AZ::Vector3> m_lidarRayDirections; //!< Ray directions in the lidar frame, computed once per template.
+        AZStd::vector<AZ::u16> m_lidarRayRings; //!< Ring of each ray.
+        AZStd::vector<float> m_lidarRayTimeOffsets; //!< Firing time of each ray relative to the scan start.
+        unsigned int m_scanColumnCount = 0; //!< Columns of rays cast in a scan, fewer than increments when columns are decimated.
+        LidarPointFilterParameters m_pointFilterParameters;
         std::shared_ptr<rclcpp::Publisher<sensor_msgs::msg::PointCloud2>> m_pointCloudPublisher;
+        std::shared_ptr<rclcpp::Publisher<sensor_msgs::msg::LaserScan>> m_laserScanPublisher;
+        OutputMode m_outputMode = OutputMode::PointCloud;
 
-        // Used only when visualisation is on - points differ since they are in global transform as opposed to local
-        AZStd::vector<AZ::Vector3> m_visualisationPoints;
-        AZ::RPI::AuxGeomDrawPtr m_drawQueue;
+        ScanExecutionMode m_scanExecutionMode = ScanExecutionMode::Synchronous;
+        unsigned int m_maxScansInFlight = 2; //!< Scans due while all slots are busy are dropped.
+        AZStd::vector<AZStd::unique_ptr<ScanSlot>> m_scanSlots;
+        AZ::JobCompletion m_scanJobsCompletion; //!< Tracks all scan jobs so that they can be awaited on deactivation.
+        size_t m_droppedScans = 0;
+        AZ::u64 m_nextScanSequence = 0; //!< Sequence number of the next scan started, which also selects its noise.
+        mutable AZStd::mutex m_publishMutex;
+        AZ::u64 m_nextPublishedSequence = 0; //!< Guarded by m_publishMutex.
+
+        bool m_isBatchedScanPending = false; //!< Synchronous scan submitted to the lidar system and not cast yet.
+        AZ::Transform m_batchedScanTransform = AZ::Transform::CreateIdentity();
+        std_msgs::msg::Header m_batchedScanHeader;
 
-        AZStd::vector<AZ::Vector3> m_lastScanResults;
+        unsigned int m_rollingScanSlices = 10; //!< Number of azimuth slices a revolution is cast in, in rolling scan mode.
+        AzPhysics::SceneHandle m_substepPhysicsScene = AzPhysics::InvalidSceneHandle;
+        AZ::u64 m_substepSensorId = 0; //!< Rolling scans are cast by a step sensor of the sensor scheduler.
+        AZ::Transform m_previousSubstepTransform = AZ::Transform::CreateIdentity();
+        bool m_hasPreviousSubstepTransform = false;
+        float m_revolutionTime = 0.0f; //!< Time since the start of the current revolution.
+        unsigned int m_castSlices = 0; //!< Slices of the current revolution cast so far.
+        std_msgs::msg::Header m_revolutionHeader; //!< Stamped at the first slice, point times are relative to it.
+
+        // Used only when visualisation is on. Points are updated once per scan and drawn every frame
+        AZStd::mutex m_visualisationMutex;
+        AZStd::vector<AZ::Vector3> m_visualisationPoints; //!< Points of the last scan in the lidar frame.
+        AZ::Transform m_visualisationTransform = AZ::Transform::CreateIdentity(); //!< Lidar pose of the last scan.
+        unsigned int m_visualisationPointBudget = 20000;
+        AZ::RPI::AuxGeomDrawPtr m_drawQueue;
 
         // TODO - change to AzPhysics::CollisionLayer, use mask instead of single layer
         unsigned int m_ignoredLayerIndex = 0;
         bool m_ignoreLayer = false;
+        bool m_useStaticSceneAcceleration = true;
     };
 } // namespace ROS2
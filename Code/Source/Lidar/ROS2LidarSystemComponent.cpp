@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project.
+ * For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#include "Lidar/ROS2LidarSystemComponent.h"
+#include "Lidar/LidarRaycaster.h"
+#include <AzCore/Serialization/EditContext.h>
+#include <AzCore/Serialization/EditContextConstants.inl>
+#include <AzCore/Serialization/SerializeContext.h>
+#include <AzCore/Settings/SettingsRegistry.h>
+#include <AzCore/std/algorithm.h>
+#include <AzFramework/Physics/PhysicsScene.h>
+
+namespace ROS2
+{
+    void ROS2LidarSystemComponent::Reflect(AZ::ReflectContext* context)
+    {
+        if (auto serializeContext = azrtti_cast<AZ::SerializeContext*>(context))
+        {
+            serializeContext->Class<ROS2LidarSystemComponent, AZ::Component>()->Version(0);
+
+            if (AZ::EditContext* ec = serializeContext->GetEditContext())
+            {
+                ec->Class<ROS2LidarSystemComponent>("ROS2 Lidar System", "Casts scans of all lidars in batched physics queries")
+                    ->ClassElement(AZ::Edit::ClassElements::EditorData, "")
+                    ->Attribute(AZ::Edit::Attributes::AppearsInAddComponentMenu, AZ_CRC("System"))
+                    ->Attribute(AZ::Edit::Attributes::Category, "ROS2")
+                    ->Attribute(AZ::Edit::Attributes::AutoExpand, true);
+            }
+        }
+    }
+
+    void ROS2LidarSystemComponent::GetProvidedServices(AZ::ComponentDescriptor::DependencyArrayType& provided)
+    {
+        provided.push_back(AZ_CRC_CE("ROS2LidarSystemService"));
+    }
+
+    void ROS2LidarSystemComponent::GetIncompatibleServices(AZ::ComponentDescriptor::DependencyArrayType& incompatible)
+    {
+        incompatible.push_back(AZ_CRC_CE("ROS2LidarSystemService"));
+    }
+
+    ROS2LidarSystemComponent::ROS2LidarSystemComponent()
+    {
+        if (LidarSystemInterface::Get() == nullptr)
+        {
+            LidarSystemInterface::Register(this);
+        }
+    }
+
+    ROS2LidarSystemComponent::~ROS2LidarSystemComponent()
+    {
+        if (LidarSystemInterface::Get() == this)
+        {
+            LidarSystemInterface::Unregister(this);
+        }
+    }
+
+    void ROS2LidarSystemComponent::Activate()
+    {
+        AZ::u64 maxRaysPerFrame = 0;
+        if (auto* settingsRegistry = AZ::SettingsRegistry::Get())
+        {
+            settingsRegistry->Get(maxRaysPerFrame, MaxRaysPerFrameRegistryPath);
+        }
+        m_maxRaysPerFrame = static_cast<size_t>(maxRaysPerFrame);
+        AZ::TickBus::Handler::BusConnect();
+    }
+
+    void ROS2LidarSystemComponent::Deactivate()
+    {
+        AZ::TickBus::Handler::BusDisconnect();
+        m_pendingScans.clear();
+        m_batches.clear();
+        AZ_TracePrintf(
+            "Lidar System Component",
+            "Cast %zu scans in %zu batches, scans were deferred by the ray budget in %zu frames\n",
+            m_batchedScanCount,
+            m_batchCount,
+            m_deferredFrameCount);
+    }
+
+    int ROS2LidarSystemComponent::GetTickOrder()
+    { // After all sensors, so that scans submitted in this frame are cast in it
+        return AZ::ComponentTickBus::TICK_LAST;
+    }
+
+    void ROS2LidarSystemComponent::SubmitScan(LidarBatchClient* client)
+    {
+        m_pendingScans.push_back(client);
+    }
+
+    void ROS2LidarSystemComponent::CancelScans(LidarBatchClient* client)
+    {
+        m_pendingScans.erase(AZStd::remove(m_pendingScans.begin(), m_pendingScans.end(), client), m_pendingScans.end());
+    }
+
+    ROS2LidarSystemComponent::Batch& ROS2LidarSystemComponent::GetBatch(AzPhysics::SceneHandle sceneHandle)
+    {
+        auto batchIt = AZStd::find_if(
+            m_batches.begin(),
+            m_batches.end(),
+            [sceneHandle](const Batch& batch)
+            {
+                return batch.m_sceneHandle == sceneHandle;
+            });
+        if (batchIt != m_batches.end())
+        {
+            return *batchIt;
+        }
+
+        m_batches.push_back({ sceneHandle, {}, {} });
+        return m_batches.back();
+    }
+
+    void ROS2LidarSystemComponent::OnTick([[maybe_unused]] float deltaTime, [[maybe_unused]] AZ::ScriptTimePoint time)
+    {
+        if (m_pendingScans.empty())
+        {
+            return;
+        }
+
+        // Scans are taken in order of submission, at least one per frame so that a scan over the budget is still cast
+        size_t batchedRayCount = 0;
+        size_t takenScanCount = 0;
+        for (; takenScanCount < m_pendingScans.size(); takenScanCount++)
+        {
+            LidarBatchClient* client = m_pendingScans[takenScanCount];
+            const size_t rayCount = client->GetBatchedScanRayCount();
+            if (m_maxRaysPerFrame > 0 && batchedRayCount > 0 && batchedRayCount + rayCount > m_maxRaysPerFrame)
+            {
+                m_deferredFrameCount++;
+                break;
+            }
+
+            LidarRaycaster* raycaster = client->PrepareBatchedScan();
+            if (!raycaster)
+            {
+                continue;
+            }
+            batchedRayCount += rayCount;
+
+            // Requests are shared pointers, so merging them does not copy the requests themselves
+            Batch& batch = GetBatch(raycaster->GetSceneHandle());
+            const auto& requests = raycaster->GetPreparedRequests();
+            batch.m_scans.push_back({ client, raycaster, batch.m_requests.size() });
+            batch.m_requests.insert(batch.m_requests.end(), requests.begin(), requests.end());
+        }
+        m_pendingScans.erase(m_pendingScans.begin(), m_pendingScans.begin() + takenScanCount);
+
+        auto* sceneInterface = AZ::Interface<AzPhysics::SceneInterface>::Get();
+        for (Batch& batch : m_batches)
+        {
+            if (batch.m_scans.empty())
+            {
+                continue;
+            }
+
+            const auto requestResults = sceneInterface->QuerySceneBatch(batch.m_sceneHandle, batch.m_requests);
+            AZ_Assert(requestResults.size() == batch.m_requests.size(), "Batch should have a result for each request");
+            for (const BatchedScan& scan : batch.m_scans)
+            {
+                scan.m_raycaster->CompleteRaycast(requestResults, scan.m_firstRequest);
+                scan.m_client->FinishBatchedScan();
+            }
+
+            m_batchCount++;
+            m_batchedScanCount += batch.m_scans.size();
+            batch.m_scans.clear(); // Capacity is kept for the next frame
+            batch.m_requests.clear();
+        }
+    }
+} // namespace ROS2
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project.
+ * For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+#pragma once
+
+#include "Lidar/LidarSystemBus.h"
+#include <AzCore/Component/Component.h>
+#include <AzCore/Component/TickBus.h>
+#include <AzCore/std/containers/vector.h>
+#include <AzFramework/Physics/Common/PhysicsSceneQueries.h>
+#include <AzFramework/Physics/Common/PhysicsTypes.h>
+
+namespace ROS2
+{
+    //! System Component which casts scans of all lidars due in a frame in one physics query batch per physics scene.
+    //! Lidars submit scans during their tick, and the batch is cast after all of them, at the end of the frame.
+    //! This saves a batch submission and scene lock per lidar, and is a single place to budget rays cast in a frame.
+    //! The budget is read from the settings registry at MaxRaysPerFrameRegistryPath, zero for no limit.
+    class ROS2LidarSystemComponent
+        : public AZ::Component
+        , public AZ::TickBus::Handler
+        , protected LidarSystemRequests
+    {
+    public:
+        AZ_COMPONENT(ROS2LidarSystemComponent, "{6B3A9E51-0C2D-4F7A-8E14-D5B2C7A9F360}");
+
+        static constexpr const char* MaxRaysPerFrameRegistryPath = "/O3DE/ROS2/Lidar/MaxRaysPerFrame";
+
+        static void Reflect(AZ::ReflectContext* context);
+        static void GetProvidedServices(AZ::ComponentDescriptor::DependencyArrayType& provided);
+        static void GetIncompatibleServices(AZ::ComponentDescriptor::DependencyArrayType& incompatible);
+
+        ROS2LidarSystemComponent();
+        ~ROS2LidarSystemComponent();
+
+    protected:
+        ////////////////////////////////////////////////////////////////////////
+        // AZ::Component interface implementation
+        void Activate() override;
+        void Deactivate() override;
+        ////////////////////////////////////////////////////////////////////////
+
+        ////////////////////////////////////////////////////////////////////////
+        // AZTickBus interface implementation
+        void OnTick(float deltaTime, AZ::ScriptTimePoint time) override;
+        int GetTickOrder() override;
+        ////////////////////////////////////////////////////////////////////////
+
+        ////////////////////////////////////////////////////////////////////////
+        // LidarSystemRequests interface implementation
+        void SubmitScan(LidarBatchClient* client) override;
+        void CancelScans(LidarBatchClient* client) override;
+        ////////////////////////////////////////////////////////////////////////
+
+    private:
+        //! Scan in a batch, with its requests starting at m_firstRequest.
+        struct BatchedScan
+        {
+            LidarBatchClient* m_client;
+            LidarRaycaster* m_raycaster;
+            size_t m_firstRequest;
+        };
+
+        //! Requests of all scans in a physics scene. Batches are reused between frames.
+        struct Batch
+        {
+            AzPhysics::SceneHandle m_sceneHandle;
+            AZStd::vector<BatchedScan> m_scans;
+            AzPhysics::SceneQueryRequests m_requests;
+        };
+
+        Batch& GetBatch(AzPhysics::SceneHandle sceneHandle);
+
+        AZStd::vector<LidarBatchClient*> m_pendingScans; //!< In order of submission.
+        AZStd::vector<Batch> m_batches;
+        size_t m_maxRaysPerFrame = 0;
+        size_t m_batchCount = 0; //!< Number of physics queries done.
+        size_t m_batchedScanCount = 0;
+        size_t m_deferredFrameCount = 0; //!< Frames in which scans were deferred due to the ray budget.
+    };
+} // namespace ROS2
@@ -68,6 +68,7 @@ namespace ROS2
         m_odometryMsg.pose.pose.position.y = translation.GetY();
         m_odometryMsg.pose.pose.position.z = translation.GetZ();
 
+        m_odometryMsg.header.stamp = GetSampleTimestamp();
         m_odometryPublisher->publish(m_odometryMsg);
     }
 
@@ -83,7 +84,7 @@ namespace ROS2
         m_odometryMsg.child_frame_id = GetFrameID().c_str();
 
         ROS2SensorComponent::Activate();
-        auto ros2Node = ROS2Interface::Get()->GetNode();
+        auto ros2Node = GetNamespaceNode();
         AZ_Assert(m_sensorConfiguration.m_publishersConfigurations.size() == 1, "Invalid configuration of publishers for Odometry sensor");
 
         const auto publisherConfig = m_sensorConfiguration.m_publishersConfigurations[Internal::kOdometryMsgType];
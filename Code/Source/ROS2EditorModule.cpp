@@ -37,6 +37,7 @@ namespace ROS2
             return AZ::ComponentTypeList{
                 azrtti_typeid<ROS2EditorSystemComponent>(),
                 azrtti_typeid<ROS2RobotImporterEditorSystemComponent>(),
+                azrtti_typeid<ROS2LidarSystemComponent>(),
             };
         }
     };
@@ -11,6 +11,7 @@
 #include "GNSS/ROS2GNSSSensorComponent.h"
 #include "Imu/ROS2ImuSensorComponent.h"
 #include "Lidar/ROS2LidarSensorComponent.h"
+#include "Lidar/ROS2LidarSystemComponent.h"
 #include "Odometry/ROS2OdometrySensorComponent.h"
 #include "ROS2/Frame/ROS2FrameComponent.h"
 #include "ROS2/Manipulator/MotorizedJointComponent.h"
@@ -44,6 +45,7 @@ namespace ROS2
                 m_descriptors.end(),
                 { ROS2SystemComponent::CreateDescriptor(),
                   ROS2RobotImporterSystemComponent::CreateDescriptor(),
+                  ROS2LidarSystemComponent::CreateDescriptor(),
                   ROS2SensorComponent::CreateDescriptor(),
                   ROS2ImuSensorComponent::CreateDescriptor(),
                   ROS2GNSSSensorComponent::CreateDescriptor(),
@@ -65,7 +67,9 @@ namespace ROS2
         //! Add required SystemComponents to the SystemEntity.
         AZ::ComponentTypeList GetRequiredSystemComponents() const override
         {
-            return AZ::ComponentTypeList{ azrtti_typeid<ROS2SystemComponent>(), azrtti_typeid<ROS2RobotImporterSystemComponent>() };
+            return AZ::ComponentTypeList{ azrtti_typeid<ROS2SystemComponent>(),
+                                          azrtti_typeid<ROS2RobotImporterSystemComponent>(),
+                                          azrtti_typeid<ROS2LidarSystemComponent>() };
         }
     };
 } // namespace ROS2
@@ -9,17 +9,40 @@
 
 #include "ROS2/Communication/QoS.h"
 #include "ROS2/Communication/TopicConfiguration.h"
+#include "ROS2/Utilities/ROS2Names.h"
 
 #include <Atom/RPI.Public/Pass/PassSystemInterface.h>
 
 #include <AzCore/Serialization/EditContext.h>
 #include <AzCore/Serialization/EditContextConstants.inl>
 #include <AzCore/Serialization/SerializeContext.h>
+#include <AzCore/Settings/SettingsRegistry.h>
 #include <AzCore/Time/ITime.h>
+#include <AzCore/std/algorithm.h>
+#include <AzCore/std/containers/unordered_set.h>
 #include <AzCore/std/smart_ptr/make_shared.h>
+#include <AzCore/std/smart_ptr/weak_ptr.h>
 
 namespace ROS2
 {
+    namespace Internal
+    {
+        //! Namespace node shared by its users, removed from the executor when the last of them releases it.
+        struct NamespaceNodeUsers
+        {
+            ~NamespaceNodeUsers()
+            {
+                if (auto executor = m_executor.lock())
+                {
+                    executor->remove_node(m_node);
+                }
+            }
+
+            std::shared_ptr<rclcpp::Node> m_node;
+            AZStd::weak_ptr<rclcpp::Executor> m_executor;
+        };
+    } // namespace Internal
+
     void ROS2SystemComponent::Reflect(AZ::ReflectContext* context)
     {
         // Reflect structs not strictly owned by any single component
@@ -81,14 +104,39 @@ namespace ROS2
     {
         rclcpp::init(0, 0);
         m_ros2Node = std::make_shared<rclcpp::Node>("o3de_ros2_node");
-        m_executor = AZStd::make_shared<rclcpp::executors::SingleThreadedExecutor>();
+
+        AZStd::string executorMode = "MainThread";
+        AZ::u64 executorThreadCount = 0;
+        if (auto* settingsRegistry = AZ::SettingsRegistry::Get())
+        {
+            settingsRegistry->Get(executorMode, ExecutorModeRegistryPath);
+            settingsRegistry->Get(executorThreadCount, ExecutorThreadCountRegistryPath);
+        }
+        if (executorMode == "MultiThreaded")
+        {
+            m_executor = AZStd::make_shared<rclcpp::executors::MultiThreadedExecutor>(
+                rclcpp::ExecutorOptions(), static_cast<size_t>(executorThreadCount));
+            m_isExecutorThreaded = true;
+        }
+        else
+        {
+            AZ_Warning(
+                "ROS2SystemComponent",
+                executorMode == "MainThread" || executorMode == "SingleThreaded",
+                "Unknown executor mode %s, callbacks are executed on the main thread",
+                executorMode.c_str());
+            m_executor = AZStd::make_shared<rclcpp::executors::SingleThreadedExecutor>();
+            m_isExecutorThreaded = executorMode == "SingleThreaded";
+        }
+        AZ_TracePrintf(
+            "ROS2SystemComponent", "Executing callbacks on %s\n", m_isExecutorThreaded ? "executor threads" : "the main thread");
         m_executor->add_node(m_ros2Node);
     }
 
     void ROS2SystemComponent::Activate()
     {
-        m_staticTFBroadcaster = AZStd::make_unique<tf2_ros::StaticTransformBroadcaster>(m_ros2Node);
-        m_dynamicTFBroadcaster = AZStd::make_unique<tf2_ros::TransformBroadcaster>(m_ros2Node);
+        m_transformAggregator = AZStd::make_unique<TransformAggregator>(m_ros2Node);
+        m_sensorScheduler = AZStd::make_unique<SensorScheduler>();
 
         auto* passSystem = AZ::RPI::PassSystemInterface::Get();
         AZ_Assert(passSystem, "Cannot get the pass system.");
@@ -102,15 +150,20 @@ namespace ROS2
 
         ROS2RequestBus::Handler::BusConnect();
         AZ::TickBus::Handler::BusConnect();
+        if (m_isExecutorThreaded)
+        {
+            StartExecutorThread();
+        }
     }
 
     void ROS2SystemComponent::Deactivate()
     {
+        StopExecutorThread();
         AZ::TickBus::Handler::BusDisconnect();
         ROS2RequestBus::Handler::BusDisconnect();
         m_loadTemplatesHandler.Disconnect();
-        m_dynamicTFBroadcaster.reset();
-        m_staticTFBroadcaster.reset();
+        m_sensorScheduler.reset();
+        m_transformAggregator.reset();
     }
 
     builtin_interfaces::msg::Time ROS2SystemComponent::GetROSTimestamp() const
@@ -123,16 +176,102 @@ namespace ROS2
         return m_ros2Node;
     }
 
-    void ROS2SystemComponent::BroadcastTransform(const geometry_msgs::msg::TransformStamped& t, bool isDynamic) const
+    std::shared_ptr<rclcpp::Node> ROS2SystemComponent::GetNamespaceNode(const AZStd::string& ros2Namespace)
     {
-        if (isDynamic)
+        if (ros2Namespace.empty())
         {
-            m_dynamicTFBroadcaster->sendTransform(t);
+            return m_ros2Node;
         }
-        else
+        if (auto found = m_namespaceNodes.find(ros2Namespace); found != m_namespaceNodes.end())
+        {
+            if (auto node = found->second.lock())
+            {
+                return node;
+            }
+        }
+
+        AZStd::unordered_set<AZStd::string> takenNodeNames;
+        for (auto it = m_namespaceNodes.begin(); it != m_namespaceNodes.end();)
+        {
+            if (auto node = it->second.lock())
+            {
+                takenNodeNames.insert(node->get_name());
+                ++it;
+            }
+            else
+            { // Released by all its users
+                it = m_namespaceNodes.erase(it);
+            }
+        }
+
+        // Namespaces such as "a/b" and "a_b" map to the same name, which is made unique with a suffix
+        AZStd::string baseNodeName = ros2Namespace;
+        AZStd::replace(baseNodeName.begin(), baseNodeName.end(), '/', '_');
+        baseNodeName = ROS2Names::RosifyName("o3de_ros2_node_" + baseNodeName);
+        AZStd::string nodeName = baseNodeName;
+        for (size_t suffix = 1; takenNodeNames.contains(nodeName); suffix++)
+        {
+            nodeName = AZStd::string::format("%s_%zu", baseNodeName.c_str(), suffix);
+        }
+
+        AZ_TracePrintf("ROS2SystemComponent", "Creating node %s for namespace %s\n", nodeName.c_str(), ros2Namespace.c_str());
+        auto users = std::make_shared<Internal::NamespaceNodeUsers>();
+        users->m_node = std::make_shared<rclcpp::Node>(nodeName.c_str());
+        users->m_executor = m_executor;
+        m_executor->add_node(users->m_node);
+        std::shared_ptr<rclcpp::Node> node(users, users->m_node.get()); // Shares ownership of the users, not only the node
+        m_namespaceNodes[ros2Namespace] = node;
+        return node;
+    }
+
+    void ROS2SystemComponent::BroadcastTransform(const geometry_msgs::msg::TransformStamped& t, bool isDynamic) const
+    {
+        m_transformAggregator->AddTransform(t, isDynamic);
+    }
+
+    void ROS2SystemComponent::QueueOnMainThread(AZStd::function<void()> function)
+    {
+        if (!m_isExecutorThreaded)
+        { // Callbacks are executed on the main thread already
+            function();
+            return;
+        }
+        m_mainThreadQueue.Push(AZStd::move(function));
+    }
+
+    void ROS2SystemComponent::StartExecutorThread()
+    {
+        m_isExecutorSpinning = true;
+        AZStd::thread_desc threadDesc;
+        threadDesc.m_name = "ROS2 executor";
+        m_executorThread = AZStd::thread(
+            threadDesc,
+            [this]()
+            {
+                m_executor->spin();
+                m_isExecutorSpinning = false;
+            });
+    }
+
+    void ROS2SystemComponent::StopExecutorThread()
+    {
+        if (!m_executorThread.joinable())
         {
-            m_staticTFBroadcaster->sendTransform(t);
+            return;
         }
+        while (m_isExecutorSpinning)
+        { // Cancelled repeatedly, since cancelling before the thread starts spinning has no effect
+            m_executor->cancel();
+            m_mainThreadQueue.RunAll();
+            AZStd::this_thread::sleep_for(AZStd::chrono::milliseconds(1));
+        }
+        m_executorThread.join();
+        m_mainThreadQueue.RunAll();
+    }
+
+    int ROS2SystemComponent::GetTickOrder()
+    { // Before all components, so that they tick with the latest time and messages
+        return AZ::ComponentTickBus::TICK_FIRST;
     }
 
     void ROS2SystemComponent::OnTick([[maybe_unused]] float deltaTime, [[maybe_unused]] AZ::ScriptTimePoint time)
@@ -140,10 +279,14 @@ namespace ROS2
         if (rclcpp::ok())
         {
             m_simulationClock.Tick();
-
-            // TODO - this can be in another thread and done with a higher resolution for less latency.
-            // TODO - callbacks will be called in the spinning thread (here, the main thread).
-            m_executor->spin_some();
+            if (m_isExecutorThreaded)
+            { // Messages received since the last tick are applied at the same point of the frame
+                m_mainThreadQueue.RunAll();
+            }
+            else
+            {
+                m_executor->spin_some();
+            }
         }
     }
 
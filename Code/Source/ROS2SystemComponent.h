@@ -8,20 +8,30 @@
 #pragma once
 
 #include "Clock/SimulationClock.h"
+#include "Communication/MainThreadCallbackQueue.h"
+#include "Frame/TransformAggregator.h"
 #include "ROS2/ROS2Bus.h"
+#include "Sensor/SensorScheduler.h"
 #include <Atom/RPI.Public/Pass/PassSystemInterface.h>
 #include <AzCore/Component/Component.h>
 #include <AzCore/Component/TickBus.h>
+#include <AzCore/std/containers/unordered_map.h>
+#include <AzCore/std/parallel/atomic.h>
+#include <AzCore/std/parallel/thread.h>
 #include <AzCore/std/smart_ptr/unique_ptr.h>
 #include <builtin_interfaces/msg/time.hpp>
 #include <memory>
 #include <rclcpp/rclcpp.hpp>
-#include <tf2_ros/static_transform_broadcaster.h>
-#include <tf2_ros/transform_broadcaster.h>
 
 namespace ROS2
 {
     //! Central singleton-like System Component for ROS2 Gem.
+    //! ROS 2 callbacks of the node are executed according to the executor mode, read from the settings registry at
+    //! ExecutorModeRegistryPath:
+    //!   - "MainThread" (default): spun on the main thread in each tick, so message latency is up to a frame.
+    //!   - "SingleThreaded": spun on a dedicated thread, as messages arrive.
+    //!   - "MultiThreaded": spun on ExecutorThreadCountRegistryPath threads, or one per core if it is zero or not set.
+    //! With executor threads, callbacks hand work on the simulation off to the main thread with QueueOnMainThread.
     class ROS2SystemComponent
         : public AZ::Component
         , protected ROS2RequestBus::Handler
@@ -30,6 +40,9 @@ namespace ROS2
     public:
         AZ_COMPONENT(ROS2SystemComponent, "{cb28d486-afa4-4a9f-a237-ac5eb42e1c87}");
 
+        static constexpr const char* ExecutorModeRegistryPath = "/O3DE/ROS2/Executor/Mode";
+        static constexpr const char* ExecutorThreadCountRegistryPath = "/O3DE/ROS2/Executor/ThreadCount";
+
         static void Reflect(AZ::ReflectContext* context);
 
         static void GetProvidedServices(AZ::ComponentDescriptor::DependencyArrayType& provided);
@@ -43,12 +56,18 @@ namespace ROS2
         //! @see ROS2Requests::GetNode()
         std::shared_ptr<rclcpp::Node> GetNode() const override;
 
+        //! @see ROS2Requests::GetNamespaceNode()
+        std::shared_ptr<rclcpp::Node> GetNamespaceNode(const AZStd::string& ros2Namespace) override;
+
         //! @see ROS2Requests::GetROSTimestamp()
         builtin_interfaces::msg::Time GetROSTimestamp() const override;
 
         // TODO - rethink ownership of this one. It needs to be a singleton-like behavior, but not necessarily here
         void BroadcastTransform(const geometry_msgs::msg::TransformStamped& t, bool isDynamic) const override;
 
+        //! @see ROS2Requests::QueueOnMainThread()
+        void QueueOnMainThread(AZStd::function<void()> function) override;
+
     protected:
         ////////////////////////////////////////////////////////////////////////
         // AZ::Component interface implementation
@@ -60,13 +79,25 @@ namespace ROS2
         ////////////////////////////////////////////////////////////////////////
         // AZTickBus interface implementation
         void OnTick(float deltaTime, AZ::ScriptTimePoint time) override;
+        int GetTickOrder() override;
         ////////////////////////////////////////////////////////////////////////
 
     private:
+        void StartExecutorThread();
+        //! Stop spinning and wait for the executor thread. Functions queued meanwhile are run, so that callbacks waiting
+        //! for the main thread can finish.
+        void StopExecutorThread();
+
         std::shared_ptr<rclcpp::Node> m_ros2Node;
-        AZStd::shared_ptr<rclcpp::executors::SingleThreadedExecutor> m_executor;
-        AZStd::unique_ptr<tf2_ros::TransformBroadcaster> m_dynamicTFBroadcaster;
-        AZStd::unique_ptr<tf2_ros::StaticTransformBroadcaster> m_staticTFBroadcaster;
+        //! Nodes by namespace, owned by their users. @see GetNamespaceNode()
+        AZStd::unordered_map<AZStd::string, std::weak_ptr<rclcpp::Node>> m_namespaceNodes;
+        AZStd::shared_ptr<rclcpp::Executor> m_executor;
+        bool m_isExecutorThreaded = false; //!< Whether callbacks are executed on executor threads rather than the main thread.
+        AZStd::thread m_executorThread;
+        AZStd::atomic_bool m_isExecutorSpinning{ false };
+        MainThreadCallbackQueue m_mainThreadQueue;
+        AZStd::unique_ptr<TransformAggregator> m_transformAggregator;
+        AZStd::unique_ptr<SensorScheduler> m_sensorScheduler; //!< Registered as SensorSchedulerInterface while active.
         SimulationClock m_simulationClock;
         //! Used for loading the pass templates of the ROS2 gem.
         void LoadPassTemplateMappings();
@@ -10,22 +10,55 @@
 #include "ROS2/Frame/ROS2FrameComponent.h"
 #include "ROS2/ROS2Bus.h"
 #include "ROS2/ROS2GemUtilities.h"
+#include "ROS2/Utilities/ROS2Conversions.h"
 #include "ROS2/Utilities/ROS2Names.h"
+#include "Sensor/SensorScheduler.h"
 #include <AzCore/Component/Entity.h>
 #include <AzCore/Serialization/EditContext.h>
 #include <AzCore/Serialization/EditContextConstants.inl>
 #include <AzCore/Serialization/SerializeContext.h>
+#include <AzFramework/Physics/PhysicsScene.h>
+#include <AzFramework/Physics/PhysicsSystem.h>
 
 namespace ROS2
 {
     void ROS2SensorComponent::Activate()
     {
-        AZ::TickBus::Handler::BusConnect();
+        if (m_sensorConfiguration.m_visualise)
+        {
+            AZ::TickBus::Handler::BusConnect();
+        }
+
+        auto frequency = m_sensorConfiguration.m_frequency;
+        AZ_Warning("ROS2SensorComponent", frequency > 0.0f, "Invalid sensor frequency %f, sampling at 1 Hz", frequency);
+        frequency = frequency > 0.0f ? frequency : 1.0f;
+
+        m_timeSinceLastSample = 0.0;
+        m_schedulePhysicsScene = GetPhysicsScene();
+        auto* sensorScheduler = SensorSchedulerInterface::Get();
+        if (!sensorScheduler)
+        {
+            AZ_Error("ROS2SensorComponent", false, "No sensor scheduler, the sensor is not sampled. Is the ROS2 system component active?");
+            return;
+        }
+        m_scheduleSensorId = sensorScheduler->AddSensor(
+            m_schedulePhysicsScene,
+            frequency,
+            [this](double sampleTime, double sampleInterval)
+            {
+                OnSampleDue(sampleTime, sampleInterval);
+            });
     }
 
     void ROS2SensorComponent::Deactivate()
     {
+        if (auto* sensorScheduler = SensorSchedulerInterface::Get())
+        {
+            sensorScheduler->RemoveSensor(m_schedulePhysicsScene, m_scheduleSensorId);
+        }
+        m_scheduleSensorId = SensorSchedule::InvalidSensorId;
         AZ::TickBus::Handler::BusDisconnect();
+        m_namespaceNode.reset(); // Publishers of the sensor keep working until they are released, they hold the node handle
     }
 
     void ROS2SensorComponent::Reflect(AZ::ReflectContext* context)
@@ -49,19 +82,53 @@ namespace ROS2
         }
     }
 
-    AZStd::string ROS2SensorComponent::GetNamespace() const
+    const AZStd::string& ROS2SensorComponent::GetNamespace() const
     {
         // TODO - hold frame?
         auto* ros2Frame = Utils::GetGameOrEditorComponent<ROS2FrameComponent>(GetEntity());
         return ros2Frame->GetNamespace();
     };
 
-    AZStd::string ROS2SensorComponent::GetFrameID() const
+    const AZStd::string& ROS2SensorComponent::GetFrameID() const
     {
         auto* ros2Frame = Utils::GetGameOrEditorComponent<ROS2FrameComponent>(GetEntity());
         return ros2Frame->GetFrameID();
     }
 
+    AzPhysics::SceneHandle ROS2SensorComponent::GetPhysicsScene() const
+    {
+        auto* physicsSystem = AZ::Interface<AzPhysics::SystemInterface>::Get();
+        auto foundBody = physicsSystem->FindAttachedBodyHandleFromEntityId(GetEntityId());
+        auto sensorPhysicsSceneHandle = foundBody.first;
+        if (foundBody.first == AzPhysics::InvalidSceneHandle)
+        {
+            auto* sceneInterface = AZ::Interface<AzPhysics::SceneInterface>::Get();
+            sensorPhysicsSceneHandle = sceneInterface->GetSceneHandle(AzPhysics::DefaultPhysicsSceneName);
+        }
+
+        AZ_Assert(sensorPhysicsSceneHandle != AzPhysics::InvalidSceneHandle, "Invalid physics scene handle for entity");
+        return sensorPhysicsSceneHandle;
+    }
+
+    double ROS2SensorComponent::GetSampleInterval() const
+    {
+        return m_sampleInterval;
+    }
+
+    builtin_interfaces::msg::Time ROS2SensorComponent::GetSampleTimestamp() const
+    {
+        return ROS2Conversions::ToROS2Time(m_sampleTime);
+    }
+
+    std::shared_ptr<rclcpp::Node> ROS2SensorComponent::GetNamespaceNode()
+    {
+        if (!m_namespaceNode)
+        {
+            m_namespaceNode = ROS2Interface::Get()->GetNamespaceNode(GetNamespace());
+        }
+        return m_namespaceNode;
+    }
+
     void ROS2SensorComponent::GetRequiredServices(AZ::ComponentDescriptor::DependencyArrayType& required)
     {
         required.push_back(AZ_CRC("ROS2Frame"));
@@ -70,27 +137,19 @@ namespace ROS2
     void ROS2SensorComponent::OnTick([[maybe_unused]] float deltaTime, [[maybe_unused]] AZ::ScriptTimePoint time)
     {
         Visualise(); // each frame
+    }
+
+    void ROS2SensorComponent::OnSampleDue(double sampleTime, double sampleInterval)
+    {
+        m_timeSinceLastSample += sampleInterval;
         if (!m_sensorConfiguration.m_publishingEnabled)
         {
             return;
         }
 
-        auto frequency = m_sensorConfiguration.m_frequency;
-
-        // TODO - add range validation (Attributes?)
-        auto frameTime = frequency == 0 ? 1 : 1 / frequency;
-
-        m_timeElapsedSinceLastTick += deltaTime;
-        if (m_timeElapsedSinceLastTick < frameTime)
-            return;
-
-        m_timeElapsedSinceLastTick -= frameTime;
-        if (deltaTime > frameTime)
-        { // Frequency higher than possible, not catching up, just keep going with each frame.
-            m_timeElapsedSinceLastTick = 0.0f;
-        }
-
-        // Note that sensor frequency can be limited by simulation tick rate (if higher sensor Hz is desired).
+        m_sampleTime = sampleTime;
+        m_sampleInterval = m_timeSinceLastSample;
+        m_timeSinceLastSample = 0.0;
         FrequencyTick();
     }
 } // namespace ROS2
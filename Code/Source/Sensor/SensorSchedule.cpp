@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project.
+ * For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#include "SensorSchedule.h"
+#include <AzCore/Debug/Trace.h>
+#include <AzCore/std/algorithm.h>
+#include <AzCore/std/math.h>
+
+namespace ROS2
+{
+    SensorSchedule::SensorId SensorSchedule::AddSensor(float frequency, SampleCallback callback)
+    {
+        AZ_Assert(frequency > 0.0f, "Sensor frequency must be positive, is %f", frequency);
+        const SensorId sensorId = m_nextSensorId++;
+        const double period = 1.0 / frequency;
+        m_sensors[sensorId] = Sensor{ period, m_time, AZStd::move(callback) };
+
+        m_dueSamples.push_back({ m_time + period * GetNextPhase(frequency), sensorId });
+        AZStd::push_heap(m_dueSamples.begin(), m_dueSamples.end(), &SensorSchedule::IsLaterSample);
+        return sensorId;
+    }
+
+    SensorSchedule::SensorId SensorSchedule::AddStepSensor(SampleCallback callback)
+    {
+        const SensorId sensorId = m_nextSensorId++;
+        m_sensors[sensorId] = Sensor{ 0.0, m_time, AZStd::move(callback) };
+        m_stepSensors.push_back(sensorId);
+        return sensorId;
+    }
+
+    void SensorSchedule::RemoveSensor(SensorId sensorId)
+    {
+        m_sensors.erase(sensorId);
+    }
+
+    void SensorSchedule::Advance(double deltaTime)
+    {
+        m_time += deltaTime;
+        m_stepSensors.erase(
+            AZStd::remove_if(
+                m_stepSensors.begin(),
+                m_stepSensors.end(),
+                [this](SensorId sensorId)
+                {
+                    return m_sensors.find(sensorId) == m_sensors.end();
+                }),
+            m_stepSensors.end());
+        const size_t stepSensorCount = m_stepSensors.size(); // Sensors added by callbacks are sampled from the next step
+        for (size_t i = 0; i < stepSensorCount; i++)
+        {
+            SampleSensor(m_stepSensors[i]);
+        }
+
+        while (!m_dueSamples.empty() && m_dueSamples.front().m_dueTime <= m_time)
+        {
+            AZStd::pop_heap(m_dueSamples.begin(), m_dueSamples.end(), &SensorSchedule::IsLaterSample);
+            DueSample sample = m_dueSamples.back();
+            m_dueSamples.pop_back();
+
+            auto sensorIt = m_sensors.find(sample.m_sensorId);
+            if (sensorIt == m_sensors.end())
+            { // Removed
+                continue;
+            }
+
+            const Sensor& sensor = sensorIt->second;
+            sample.m_dueTime += sensor.m_period;
+            if (sample.m_dueTime <= m_time)
+            { // Due again within this step, skip to the first sample after it
+                auto skippedCount = static_cast<size_t>(AZStd::floor((m_time - sample.m_dueTime) / sensor.m_period)) + 1;
+                sample.m_dueTime += skippedCount * sensor.m_period;
+                while (sample.m_dueTime <= m_time)
+                { // Rounding of the division
+                    sample.m_dueTime += sensor.m_period;
+                    skippedCount++;
+                }
+                m_skippedSampleCount += skippedCount;
+            }
+            m_dueSamples.push_back(sample);
+            AZStd::push_heap(m_dueSamples.begin(), m_dueSamples.end(), &SensorSchedule::IsLaterSample);
+
+            SampleSensor(sample.m_sensorId); // Called last, as the callback can add or remove sensors, including this one
+        }
+    }
+
+    void SensorSchedule::SampleSensor(SensorId sensorId)
+    {
+        auto sensorIt = m_sensors.find(sensorId);
+        if (sensorIt == m_sensors.end())
+        { // Removed by a callback earlier in this step
+            return;
+        }
+
+        Sensor& sensor = sensorIt->second;
+        const double sampleInterval = m_time - sensor.m_lastSampleTime;
+        sensor.m_lastSampleTime = m_time;
+
+        // Moved out of the sensor, as the callback can add or remove sensors, which invalidates references to them
+        SampleCallback callback = AZStd::move(sensor.m_callback);
+        callback(m_time, sampleInterval);
+        if (sensorIt = m_sensors.find(sensorId); sensorIt != m_sensors.end())
+        {
+            sensorIt->second.m_callback = AZStd::move(callback);
+        }
+    }
+
+    bool SensorSchedule::IsEmpty() const
+    {
+        return m_sensors.empty();
+    }
+
+    double SensorSchedule::GetTime() const
+    {
+        return m_time;
+    }
+
+    size_t SensorSchedule::GetSkippedSampleCount() const
+    {
+        return m_skippedSampleCount;
+    }
+
+    bool SensorSchedule::IsLaterSample(const DueSample& sample, const DueSample& otherSample)
+    {
+        return sample.m_dueTime != otherSample.m_dueTime ? sample.m_dueTime > otherSample.m_dueTime
+                                                         : sample.m_sensorId > otherSample.m_sensorId;
+    }
+
+    double SensorSchedule::GetNextPhase(float frequency)
+    {
+        // Van der Corput sequence: 0, 1/2, 1/4, 3/4, 1/8... spreads any number of sensors evenly over the period,
+        // without moving sensors already scheduled. The first sensor is due one period after it is added.
+        AZ::u32 index = m_sensorCountByFrequency[frequency]++;
+        double phase = 0.0;
+        for (double fraction = 0.5; index > 0; index >>= 1, fraction *= 0.5)
+        {
+            if (index & 1)
+            {
+                phase += fraction;
+            }
+        }
+        return 1.0 - phase;
+    }
+} // namespace ROS2
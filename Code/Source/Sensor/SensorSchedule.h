@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project.
+ * For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+#pragma once
+
+#include <AzCore/base.h>
+#include <AzCore/std/containers/unordered_map.h>
+#include <AzCore/std/containers/vector.h>
+#include <AzCore/std/functional.h>
+
+namespace ROS2
+{
+    //! Samples sensors at fixed rates on a simulation clock advanced in steps, such as physics substeps.
+    //! Samples due are kept in a priority queue ordered by their due time, so a step only visits sensors which are due.
+    //! A sensor due several times within one step is sampled once, as the simulation state does not change within it,
+    //! and its next sample is the first one due after the step; rates are therefore limited by the step rate only.
+    //! Phases of sensors with the same rate are staggered over their period, so that they are not all due in the same step.
+    class SensorSchedule
+    {
+    public:
+        using SensorId = AZ::u64;
+        //! Called when a sensor is due, with the simulation time at the end of the step it is sampled in, which is the time of
+        //! the state it samples, and the simulation time since its previous sample, or since it was added [s].
+        using SampleCallback = AZStd::function<void(double sampleTime, double sampleInterval)>;
+        static constexpr SensorId InvalidSensorId = 0;
+
+        //! Add a sensor to be sampled at a rate.
+        //! @param frequency - sample rate [Hz], positive
+        //! @param callback - called in Advance when the sensor is due
+        //! @return Id of the sensor, to remove it with.
+        SensorId AddSensor(float frequency, SampleCallback callback);
+
+        //! Add a sensor to be sampled on every step, before sensors due in it, such as one which sweeps over the time of steps.
+        //! @param callback - called in each Advance after the one it is added in
+        //! @return Id of the sensor, to remove it with.
+        SensorId AddStepSensor(SampleCallback callback);
+
+        //! Stop sampling a sensor. Can be called from sample callbacks.
+        void RemoveSensor(SensorId sensorId);
+
+        //! Advance the simulation time and sample sensors due until the new time, in order of their due time.
+        //! @param deltaTime - simulation time step [s]
+        void Advance(double deltaTime);
+
+        bool IsEmpty() const;
+        double GetTime() const; //!< Simulation time since the schedule was created [s].
+        size_t GetSkippedSampleCount() const; //!< Samples not taken, due more than once within a step.
+
+    private:
+        struct Sensor
+        {
+            double m_period;
+            double m_lastSampleTime;
+            SampleCallback m_callback;
+        };
+
+        //! Sample due. Samples of removed sensors are left in the queue and discarded when they come up.
+        struct DueSample
+        {
+            double m_dueTime;
+            SensorId m_sensorId;
+        };
+
+        //! Orders the heap of due samples so that the earliest one is on top, the first added one among equal due times.
+        static bool IsLaterSample(const DueSample& sample, const DueSample& otherSample);
+
+        //! Phase offset of the next sensor with a given rate, as a fraction of its period.
+        double GetNextPhase(float frequency);
+
+        //! Call the callback of a sensor, if it is not removed, and set its last sample time.
+        void SampleSensor(SensorId sensorId);
+
+        AZStd::unordered_map<SensorId, Sensor> m_sensors;
+        AZStd::vector<DueSample> m_dueSamples; //!< Min-heap by due time.
+        AZStd::vector<SensorId> m_stepSensors; //!< Sensors sampled on every step; removed ones are left until the next step.
+        AZStd::unordered_map<float, AZ::u32> m_sensorCountByFrequency; //!< Sensors ever added with a rate, for staggering.
+        SensorId m_nextSensorId = InvalidSensorId + 1;
+        double m_time = 0.0;
+        size_t m_skippedSampleCount = 0;
+    };
+} // namespace ROS2
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project.
+ * For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#include "SensorScheduler.h"
+#include "ROS2/ROS2Bus.h"
+#include "ROS2/Utilities/ROS2Conversions.h"
+#include <AzCore/std/algorithm.h>
+#include <AzCore/std/smart_ptr/make_unique.h>
+#include <AzFramework/Physics/PhysicsScene.h>
+
+namespace ROS2
+{
+    SensorScheduler::SensorScheduler()
+    {
+        if (SensorSchedulerInterface::Get() == nullptr)
+        {
+            SensorSchedulerInterface::Register(this);
+        }
+    }
+
+    SensorScheduler::~SensorScheduler()
+    {
+        if (SensorSchedulerInterface::Get() == this)
+        {
+            SensorSchedulerInterface::Unregister(this);
+        }
+        for (const auto& sceneSchedule : m_sceneSchedules)
+        {
+            AZ_TracePrintf(
+                "SensorScheduler",
+                "Skipped %zu sensor samples due more than once within a physics substep\n",
+                sceneSchedule->m_schedule.GetSkippedSampleCount());
+        }
+    }
+
+    SensorSchedule::SensorId SensorScheduler::AddSensor(
+        AzPhysics::SceneHandle sceneHandle, float frequency, SensorSchedule::SampleCallback callback)
+    {
+        SceneSchedule& sceneSchedule = GetSceneSchedule(sceneHandle);
+        return sceneSchedule.m_schedule.AddSensor(
+            frequency,
+            [schedule = &sceneSchedule, callback = AZStd::move(callback)](double sampleTime, double sampleInterval)
+            {
+                callback(schedule->m_clockOffset + sampleTime, sampleInterval);
+            });
+    }
+
+    SensorSchedule::SensorId SensorScheduler::AddStepSensor(AzPhysics::SceneHandle sceneHandle, SensorSchedule::SampleCallback callback)
+    {
+        SceneSchedule& sceneSchedule = GetSceneSchedule(sceneHandle);
+        return sceneSchedule.m_schedule.AddStepSensor(
+            [schedule = &sceneSchedule, callback = AZStd::move(callback)](double sampleTime, double sampleInterval)
+            {
+                callback(schedule->m_clockOffset + sampleTime, sampleInterval);
+            });
+    }
+
+    SensorScheduler::SceneSchedule& SensorScheduler::GetSceneSchedule(AzPhysics::SceneHandle sceneHandle)
+    {
+        auto* physicsSystem = AZ::Interface<AzPhysics::SystemInterface>::Get();
+        if (!m_preSimulateHandler.IsConnected())
+        { // Frames of all scenes are simulated together, with the same time step
+            m_preSimulateHandler = AzPhysics::SystemEvents::OnPresimulateEvent::Handler(
+                [this](float deltaTime)
+                {
+                    m_frameTime = ROS2Conversions::FromROS2Time(ROS2Interface::Get()->GetROSTimestamp());
+                    const float fixedTimestep = AZ::Interface<AzPhysics::SystemInterface>::Get()->GetConfiguration()->m_fixedTimestep;
+                    m_accumulatedTime += deltaTime;
+                    m_predictedSubstepCount = fixedTimestep > 0.0f ? static_cast<AZ::u32>(m_accumulatedTime / fixedTimestep) : 1;
+                    for (const auto& sceneSchedule : m_sceneSchedules)
+                    {
+                        sceneSchedule->m_frameSubstepCount = 0;
+                    }
+                });
+            m_postSimulateHandler = AzPhysics::SystemEvents::OnPostsimulateEvent::Handler(
+                [this]([[maybe_unused]] float deltaTime)
+                {
+                    const float fixedTimestep = AZ::Interface<AzPhysics::SystemInterface>::Get()->GetConfiguration()->m_fixedTimestep;
+                    AZ::u32 substepCount = m_predictedSubstepCount;
+                    for (const auto& sceneSchedule : m_sceneSchedules)
+                    { // Substeps actually simulated, in case the prediction was off by rounding
+                        substepCount = sceneSchedule->m_frameSubstepCount > 0 ? sceneSchedule->m_frameSubstepCount : substepCount;
+                    }
+                    m_accumulatedTime = fixedTimestep > 0.0f
+                        ? AZStd::clamp(m_accumulatedTime - substepCount * fixedTimestep, 0.0f, fixedTimestep)
+                        : 0.0f;
+                });
+            physicsSystem->RegisterPreSimulateEvent(m_preSimulateHandler);
+            physicsSystem->RegisterPostSimulateEvent(m_postSimulateHandler);
+        }
+
+        auto sceneIt = AZStd::find_if(
+            m_sceneSchedules.begin(),
+            m_sceneSchedules.end(),
+            [sceneHandle](const AZStd::unique_ptr<SceneSchedule>& sceneSchedule)
+            {
+                return sceneSchedule->m_sceneHandle == sceneHandle;
+            });
+        if (sceneIt == m_sceneSchedules.end())
+        {
+            auto sceneSchedule = AZStd::make_unique<SceneSchedule>();
+            sceneSchedule->m_sceneHandle = sceneHandle;
+            sceneSchedule->m_simulationFinishHandler = AzPhysics::SceneEvents::OnSceneSimulationFinishHandler(
+                [this, schedule = sceneSchedule.get()]([[maybe_unused]] AzPhysics::SceneHandle simulatedSceneHandle, float fixedDeltaTime)
+                {
+                    OnSubstepFinished(*schedule, fixedDeltaTime);
+                });
+            m_sceneSchedules.push_back(AZStd::move(sceneSchedule));
+            sceneIt = m_sceneSchedules.end() - 1;
+        }
+
+        SceneSchedule& sceneSchedule = **sceneIt;
+        if (!sceneSchedule.m_simulationFinishHandler.IsConnected())
+        { // Disconnected when the scene is removed, such as with its level, and a scene with the same handle can be created later
+            auto* sceneInterface = AZ::Interface<AzPhysics::SceneInterface>::Get();
+            sceneInterface->RegisterSceneSimulationFinishHandler(sceneHandle, sceneSchedule.m_simulationFinishHandler);
+        }
+        return sceneSchedule;
+    }
+
+    void SensorScheduler::OnSubstepFinished(SceneSchedule& sceneSchedule, float fixedDeltaTime)
+    {
+        // The last substep of the frame ends at the time of the frame, earlier ones a time step before each other.
+        // Substeps beyond the prediction end at the time of the frame too, so that samples are never ahead of the clock.
+        sceneSchedule.m_frameSubstepCount++;
+        const AZ::u32 laterSubstepCount = m_predictedSubstepCount > sceneSchedule.m_frameSubstepCount
+            ? m_predictedSubstepCount - sceneSchedule.m_frameSubstepCount
+            : 0;
+        const double substepEndTime = m_frameTime - laterSubstepCount * static_cast<double>(fixedDeltaTime);
+        sceneSchedule.m_clockOffset = substepEndTime - (sceneSchedule.m_schedule.GetTime() + fixedDeltaTime);
+        sceneSchedule.m_schedule.Advance(fixedDeltaTime);
+    }
+
+    void SensorScheduler::RemoveSensor(AzPhysics::SceneHandle sceneHandle, SensorSchedule::SensorId sensorId)
+    {
+        auto sceneIt = AZStd::find_if(
+            m_sceneSchedules.begin(),
+            m_sceneSchedules.end(),
+            [sceneHandle](const AZStd::unique_ptr<SceneSchedule>& sceneSchedule)
+            {
+                return sceneSchedule->m_sceneHandle == sceneHandle;
+            });
+        if (sceneIt == m_sceneSchedules.end())
+        {
+            return;
+        }
+
+        // Kept when empty, as sensors can be removed from within sample callbacks of its schedule
+        (*sceneIt)->m_schedule.RemoveSensor(sensorId);
+    }
+} // namespace ROS2
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project.
+ * For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+#pragma once
+
+#include "SensorSchedule.h"
+#include <AzCore/Interface/Interface.h>
+#include <AzCore/RTTI/RTTI.h>
+#include <AzCore/std/containers/vector.h>
+#include <AzCore/std/smart_ptr/unique_ptr.h>
+#include <AzFramework/Physics/Common/PhysicsEvents.h>
+#include <AzFramework/Physics/Common/PhysicsTypes.h>
+#include <AzFramework/Physics/PhysicsSystem.h>
+
+namespace ROS2
+{
+    //! Interface to the central sensor scheduler, which samples sensors at their rates on simulation time.
+    //! Use this API through SensorSchedulerInterface, on the main thread.
+    class SensorSchedulerRequests
+    {
+    public:
+        AZ_RTTI(SensorSchedulerRequests, "{0E6F3B9D-52C1-4A87-9D2E-7B41C85A6F13}");
+        virtual ~SensorSchedulerRequests() = default;
+
+        //! Sample a sensor at a rate, at the end of physics substeps of a physics scene.
+        //! @param sceneHandle - physics scene which simulation time the sensor is sampled on
+        //! @param frequency - sample rate [Hz], positive; rates above the physics substep rate are limited to it
+        //! @param callback - called on the main thread when the sensor is due, @see SensorSchedule::SampleCallback.
+        //! Its sample time is the simulation time of the sample on the ROS clock, @see ROS2Requests::GetROSTimestamp
+        //! @return Id of the sensor in the scene, to remove it with.
+        virtual SensorSchedule::SensorId AddSensor(
+            AzPhysics::SceneHandle sceneHandle, float frequency, SensorSchedule::SampleCallback callback) = 0;
+
+        //! Sample a sensor at the end of every physics substep of a physics scene, before sensors due in it, such as to sweep
+        //! over the time of each substep. The sample interval is the duration of the substep.
+        //! @see AddSensor
+        virtual SensorSchedule::SensorId AddStepSensor(AzPhysics::SceneHandle sceneHandle, SensorSchedule::SampleCallback callback) = 0;
+
+        //! Stop sampling a sensor, such as when it is deactivated.
+        virtual void RemoveSensor(AzPhysics::SceneHandle sceneHandle, SensorSchedule::SensorId sensorId) = 0;
+    };
+
+    using SensorSchedulerInterface = AZ::Interface<SensorSchedulerRequests>;
+
+    //! Drives a SensorSchedule per physics scene with its simulation time, advanced by each physics substep.
+    //! Sensors are sampled on simulation time rather than frame time, so their rates do not depend on the frame rate and
+    //! can be higher than it, and they see the state of the physics substep they are sampled after.
+    //! Substeps are mapped to the ROS clock in each frame: the last substep of a frame ends at the time of the frame, as the
+    //! substeps catch up with it, and earlier ones end a fixed time step before each other. Samples are thus stamped with
+    //! the substep they are sampled after, never ahead of the clock, and time dropped by physics, such as when the frame
+    //! time is clamped, does not offset them from the clock. The substeps of a frame are predicted from its time step,
+    //! as the physics system accumulates it.
+    class SensorScheduler : public SensorSchedulerRequests
+    {
+    public:
+        SensorScheduler();
+        ~SensorScheduler();
+
+        ////////////////////////////////////////////////////////////////////////
+        // SensorSchedulerRequests interface implementation
+        SensorSchedule::SensorId AddSensor(
+            AzPhysics::SceneHandle sceneHandle, float frequency, SensorSchedule::SampleCallback callback) override;
+        SensorSchedule::SensorId AddStepSensor(AzPhysics::SceneHandle sceneHandle, SensorSchedule::SampleCallback callback) override;
+        void RemoveSensor(AzPhysics::SceneHandle sceneHandle, SensorSchedule::SensorId sensorId) override;
+        ////////////////////////////////////////////////////////////////////////
+
+    private:
+        //! Schedule of sensors of a physics scene.
+        struct SceneSchedule
+        {
+            AzPhysics::SceneHandle m_sceneHandle;
+            SensorSchedule m_schedule;
+            AzPhysics::SceneEvents::OnSceneSimulationFinishHandler m_simulationFinishHandler;
+            double m_clockOffset = 0.0; //!< ROS clock time minus schedule time, in the substep being simulated [s].
+            AZ::u32 m_frameSubstepCount = 0; //!< Substeps simulated in the current frame.
+        };
+
+        //! Get the schedule of a physics scene, created and connected to its substeps if needed.
+        SceneSchedule& GetSceneSchedule(AzPhysics::SceneHandle sceneHandle);
+
+        //! Sample sensors of a schedule due in the physics substep which has just finished.
+        void OnSubstepFinished(SceneSchedule& sceneSchedule, float fixedDeltaTime);
+
+        AZStd::vector<AZStd::unique_ptr<SceneSchedule>> m_sceneSchedules;
+        AzPhysics::SystemEvents::OnPresimulateEvent::Handler m_preSimulateHandler;
+        AzPhysics::SystemEvents::OnPostsimulateEvent::Handler m_postSimulateHandler;
+        double m_frameTime = 0.0; //!< Time of the frame being simulated on the ROS clock [s].
+        float m_accumulatedTime = 0.0f; //!< Time not simulated yet, as accumulated by the physics system [s].
+        AZ::u32 m_predictedSubstepCount = 0; //!< Substeps predicted to be simulated in the current frame.
+    };
+} // namespace ROS2
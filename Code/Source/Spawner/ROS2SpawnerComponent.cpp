@@ -12,12 +12,35 @@
 #include "ROS2/ROS2GemUtilities.h"
 #include <AzCore/Serialization/EditContext.h>
 #include <AzCore/Serialization/SerializeContext.h>
+#include <AzCore/std/parallel/binary_semaphore.h>
+#include <AzCore/std/smart_ptr/make_shared.h>
+#include <AzCore/std/smart_ptr/weak_ptr.h>
 #include <AzFramework/Spawnable/Spawnable.h>
 
 #include <ROS2/Utilities/ROS2Conversions.h>
 
 namespace ROS2
 {
+    namespace Internal
+    {
+        //! Run a service handler on the main thread and wait for it, since the response is sent when the service callback returns.
+        //! The handler is skipped, leaving the default response, if the activation token is released before it runs.
+        void CallOnMainThread(AZStd::weak_ptr<bool> activationToken, AZStd::function<void()> handler)
+        {
+            auto handled = AZStd::make_shared<AZStd::binary_semaphore>();
+            ROS2Interface::Get()->QueueOnMainThread(
+                [activationToken, handler = AZStd::move(handler), handled]()
+                {
+                    if (activationToken.lock())
+                    {
+                        handler();
+                    }
+                    handled->release();
+                });
+            handled->acquire();
+        }
+    } // namespace Internal
+
     ROS2SpawnerComponent::ROS2SpawnerComponent()
     {
         // TODO - currently causes errors on close. It is here to enable URDF spawning in default point.
@@ -32,38 +55,61 @@ namespace ROS2
     void ROS2SpawnerComponent::Activate()
     {
         auto ros2Node = ROS2Interface::Get()->GetNode();
+        m_activationToken = AZStd::make_shared<bool>(true);
+        const AZStd::weak_ptr<bool> activationToken = m_activationToken;
 
         m_getSpawnablesNamesService = ros2Node->create_service<gazebo_msgs::srv::GetWorldProperties>(
             "get_available_spawnable_names",
-            [this](const GetAvailableSpawnableNamesRequest request, GetAvailableSpawnableNamesResponse response)
+            [this, activationToken](const GetAvailableSpawnableNamesRequest request, GetAvailableSpawnableNamesResponse response)
             {
-                GetAvailableSpawnableNames(request, response);
+                Internal::CallOnMainThread(
+                    activationToken,
+                    [this, request, response]()
+                    {
+                        GetAvailableSpawnableNames(request, response);
+                    });
             });
 
         m_spawnService = ros2Node->create_service<gazebo_msgs::srv::SpawnEntity>(
             "spawn_entity",
-            [this](const SpawnEntityRequest request, SpawnEntityResponse response)
+            [this, activationToken](const SpawnEntityRequest request, SpawnEntityResponse response)
             {
-                SpawnEntity(request, response);
+                Internal::CallOnMainThread(
+                    activationToken,
+                    [this, request, response]()
+                    {
+                        SpawnEntity(request, response);
+                    });
             });
 
         m_getSpawnPointInfoService = ros2Node->create_service<gazebo_msgs::srv::GetModelState>(
             "get_spawn_point_info",
-            [this](const GetSpawnPointInfoRequest request, GetSpawnPointInfoResponse response)
+            [this, activationToken](const GetSpawnPointInfoRequest request, GetSpawnPointInfoResponse response)
             {
-                GetSpawnPointInfo(request, response);
+                Internal::CallOnMainThread(
+                    activationToken,
+                    [this, request, response]()
+                    {
+                        GetSpawnPointInfo(request, response);
+                    });
             });
 
         m_getSpawnPointsNamesService = ros2Node->create_service<gazebo_msgs::srv::GetWorldProperties>(
             "get_spawn_points_names",
-            [this](const GetSpawnPointsNamesRequest request, GetSpawnPointsNamesResponse response)
+            [this, activationToken](const GetSpawnPointsNamesRequest request, GetSpawnPointsNamesResponse response)
             {
-                GetSpawnPointsNames(request, response);
+                Internal::CallOnMainThread(
+                    activationToken,
+                    [this, request, response]()
+                    {
+                        GetSpawnPointsNames(request, response);
+                    });
             });
     }
 
     void ROS2SpawnerComponent::Deactivate()
     {
+        m_activationToken.reset(); // Requests waiting for the main thread are answered with default responses
         m_getSpawnablesNamesService.reset();
         m_spawnService.reset();
         m_getSpawnPointInfoService.reset();
@@ -58,6 +58,8 @@ namespace ROS2
         rclcpp::Service<gazebo_msgs::srv::GetWorldProperties>::SharedPtr m_getSpawnPointsNamesService;
         rclcpp::Service<gazebo_msgs::srv::SpawnEntity>::SharedPtr m_spawnService;
         rclcpp::Service<gazebo_msgs::srv::GetModelState>::SharedPtr m_getSpawnPointInfoService;
+        //! Owned while active. Service requests are handled on the main thread only while it is, see ROS2Requests::QueueOnMainThread.
+        AZStd::shared_ptr<bool> m_activationToken;
 
         AZ::Transform m_defaultSpawnPose = { AZ::Vector3{ 0, 0, 0 }, AZ::Quaternion{ 0, 0, 0, 1 }, 1.0 };
 
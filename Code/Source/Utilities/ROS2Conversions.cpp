@@ -8,6 +8,7 @@
 
 #include "ROS2/Utilities/ROS2Conversions.h"
 #include <AzCore/Math/Transform.h>
+#include <AzCore/std/math.h>
 
 namespace ROS2
 {
@@ -71,4 +72,18 @@ namespace ROS2
         azquaternion.SetW(ros2quaternion.w);
         return azquaternion;
     }
+
+    builtin_interfaces::msg::Time ROS2Conversions::ToROS2Time(double seconds)
+    {
+        const auto nanoseconds = static_cast<int64_t>(AZStd::round(seconds * 1e9));
+        builtin_interfaces::msg::Time ros2time;
+        ros2time.sec = static_cast<int32_t>(nanoseconds / 1000000000);
+        ros2time.nanosec = static_cast<uint32_t>(nanoseconds % 1000000000);
+        return ros2time;
+    }
+
+    double ROS2Conversions::FromROS2Time(const builtin_interfaces::msg::Time& ros2time)
+    {
+        return ros2time.sec + ros2time.nanosec * 1e-9;
+    }
 } // namespace ROS2
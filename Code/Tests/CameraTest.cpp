@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project.
+ * For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#include <AzCore/UnitTest/TestTypes.h>
+#include <AzTest/AzTest.h>
+#include <cmath>
+
+#include "Camera/CameraImageEncoder.h"
+#include "Camera/CameraPointCloud.h"
+
+namespace UnitTest
+{
+
+    class CameraTest : public AllocatorsTestFixture
+    {
+    };
+
+    TEST_F(CameraTest, ConvertRgbaToRgb)
+    {
+        // Enough pixels for both the vectorized loop and the remainder
+        constexpr size_t pixelCount = 11;
+        std::vector<uint8_t> rgba(pixelCount * 4);
+        for (size_t i = 0; i < rgba.size(); i++)
+        {
+            rgba[i] = static_cast<uint8_t>(i);
+        }
+
+        std::vector<uint8_t> rgb(pixelCount * 3);
+        std::vector<uint8_t> bgr(pixelCount * 3);
+        ROS2::CameraImageEncoder::ConvertRgbaToRgb(rgba.data(), rgb.data(), pixelCount, false);
+        ROS2::CameraImageEncoder::ConvertRgbaToRgb(rgba.data(), bgr.data(), pixelCount, true);
+        for (size_t i = 0; i < pixelCount; i++)
+        {
+            EXPECT_EQ(rgb[i * 3], rgba[i * 4]);
+            EXPECT_EQ(rgb[i * 3 + 1], rgba[i * 4 + 1]);
+            EXPECT_EQ(rgb[i * 3 + 2], rgba[i * 4 + 2]);
+            EXPECT_EQ(bgr[i * 3], rgba[i * 4 + 2]);
+            EXPECT_EQ(bgr[i * 3 + 1], rgba[i * 4 + 1]);
+            EXPECT_EQ(bgr[i * 3 + 2], rgba[i * 4]);
+        }
+    }
+
+    TEST_F(CameraTest, EncodePng)
+    {
+        constexpr uint32_t width = 64;
+        constexpr uint32_t height = 32;
+        const std::vector<uint8_t> rgb(width * height * 3, 128);
+
+        std::vector<uint8_t> filteredRows;
+        std::vector<uint8_t> png;
+        ASSERT_TRUE(ROS2::CameraImageEncoder::EncodePng(rgb.data(), width, height, filteredRows, png));
+
+        const std::vector<uint8_t> signature = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        ASSERT_GT(png.size(), signature.size() + 12);
+        EXPECT_TRUE(std::equal(signature.begin(), signature.end(), png.begin()));
+
+        // Header chunk follows the signature, its data starts with big endian width and height
+        EXPECT_EQ(0, memcmp(png.data() + 12, "IHDR", 4));
+        EXPECT_EQ(png[16 + 3], width);
+        EXPECT_EQ(png[20 + 3], height);
+        EXPECT_EQ(0, memcmp(png.data() + png.size() - 8, "IEND", 4));
+
+        // Uniform image is filtered to zeros, which compress well
+        EXPECT_LT(png.size(), rgb.size() / 10);
+    }
+    TEST_F(CameraTest, PngFormat)
+    {
+        // compressed_image_transport expects bgr8 for true colour PNGs and swaps channels otherwise
+        EXPECT_EQ(ROS2::CameraImageEncoder::GetPngFormat("rgb8"), "rgb8; png compressed bgr8");
+        EXPECT_EQ(ROS2::CameraImageEncoder::GetPngFormat("bgr8"), "bgr8; png compressed bgr8");
+    }
+
+    TEST_F(CameraTest, MakeRayTable)
+    {
+        // Focal length of one pixel, principal point in the middle of a 2x2 image
+        const AZStd::array<double, 9> intrinsics = { 1.0, 0.0, 1.0, 0.0, 1.0, 1.0, 0.0, 0.0, 1.0 };
+        std::vector<float> rays;
+        ROS2::CameraPointCloud::MakeRayTable(intrinsics, 2, 2, rays);
+        const std::vector<float> expectedRays = { -0.5f, -0.5f, 1.0f, 0.5f, -0.5f, 1.0f, -0.5f, 0.5f, 1.0f, 0.5f, 0.5f, 1.0f };
+        ASSERT_EQ(rays.size(), expectedRays.size());
+        for (size_t i = 0; i < rays.size(); i++)
+        {
+            EXPECT_FLOAT_EQ(rays[i], expectedRays[i]);
+        }
+    }
+
+    TEST_F(CameraTest, ConvertDepthToPoints)
+    {
+        // Enough pixels for both the vectorized loop and the remainder
+        constexpr size_t pixelCount = 11;
+        constexpr float maxDepth = 100.0f;
+        std::vector<float> depth(pixelCount);
+        std::vector<float> rays(pixelCount * 3);
+        for (size_t i = 0; i < pixelCount; i++)
+        {
+            depth[i] = 0.5f + i;
+            rays[i * 3] = 0.1f * i;
+            rays[i * 3 + 1] = -0.2f * i;
+            rays[i * 3 + 2] = 1.0f;
+        }
+        depth[2] = maxDepth; // No surface
+        depth[9] = 0.0f;
+
+        std::vector<float> points(pixelCount * 3);
+        ROS2::CameraPointCloud::ConvertDepthToPoints(depth.data(), rays.data(), pixelCount, maxDepth, points.data());
+        for (size_t i = 0; i < pixelCount; i++)
+        {
+            if (i == 2 || i == 9)
+            {
+                EXPECT_TRUE(std::isnan(points[i * 3]) && std::isnan(points[i * 3 + 1]) && std::isnan(points[i * 3 + 2]));
+                continue;
+            }
+            EXPECT_FLOAT_EQ(points[i * 3], rays[i * 3] * depth[i]);
+            EXPECT_FLOAT_EQ(points[i * 3 + 1], rays[i * 3 + 1] * depth[i]);
+            EXPECT_FLOAT_EQ(points[i * 3 + 2], depth[i]);
+        }
+    }
+
+} // namespace UnitTest
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project.
+ * For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#include <AzCore/UnitTest/TestTypes.h>
+#include <AzCore/std/parallel/thread.h>
+#include <AzTest/AzTest.h>
+
+#include "Communication/MainThreadCallbackQueue.h"
+
+namespace UnitTest
+{
+
+    class CommunicationTest : public AllocatorsTestFixture
+    {
+    };
+
+    TEST_F(CommunicationTest, MainThreadCallbackQueueRunsInOrder)
+    {
+        ROS2::MainThreadCallbackQueue queue;
+        std::vector<int> values;
+        for (int i = 0; i < 5; i++)
+        {
+            queue.Push(
+                [&values, i]()
+                {
+                    values.push_back(i);
+                });
+        }
+
+        EXPECT_EQ(queue.RunAll(), 5);
+        EXPECT_EQ(values, std::vector<int>({ 0, 1, 2, 3, 4 }));
+        EXPECT_EQ(queue.RunAll(), 0);
+    }
+
+    TEST_F(CommunicationTest, MainThreadCallbackQueueConcurrentPush)
+    {
+        constexpr int threadCount = 4;
+        constexpr int pushCount = 1000;
+        ROS2::MainThreadCallbackQueue queue;
+        std::vector<std::vector<int>> valuesByThread(threadCount);
+
+        AZStd::vector<AZStd::thread> threads;
+        for (int t = 0; t < threadCount; t++)
+        {
+            threads.emplace_back(
+                [&queue, &valuesByThread, t]()
+                {
+                    for (int i = 0; i < pushCount; i++)
+                    {
+                        queue.Push(
+                            [&valuesByThread, t, i]()
+                            {
+                                valuesByThread[t].push_back(i);
+                            });
+                    }
+                });
+        }
+
+        size_t runCount = 0;
+        while (runCount < threadCount * pushCount)
+        { // Runs concurrently with pushing
+            runCount += queue.RunAll();
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        EXPECT_EQ(queue.RunAll(), 0);
+        for (const auto& values : valuesByThread)
+        { // Order of each thread is kept
+            ASSERT_EQ(values.size(), pushCount);
+            for (int i = 0; i < pushCount; i++)
+            {
+                EXPECT_EQ(values[i], i);
+            }
+        }
+    }
+
+} // namespace UnitTest
@@ -0,0 +1,419 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project.
+ * For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#include <AzCore/Math/MathUtils.h>
+#include <AzCore/UnitTest/TestTypes.h>
+#include <AzCore/std/math.h>
+#include <AzTest/AzTest.h>
+
+#include "Lidar/LidarNoise.h"
+#include "Lidar/LidarPointCloud.h"
+#include "Lidar/LidarPointFilter.h"
+#include "Lidar/LidarRaycaster.h"
+#include "Lidar/LidarStaticScene.h"
+#include "Lidar/LidarTemplateUtils.h"
+
+namespace UnitTest
+{
+
+    class LidarTest : public AllocatorsTestFixture
+    {
+    };
+
+    TEST_F(LidarTest, RayDirectionsCountAndLength)
+    {
+        const auto lidarTemplate = ROS2::LidarTemplateUtils::GetTemplate(ROS2::LidarTemplate::Generic3DLidar);
+        const auto directions = ROS2::LidarTemplateUtils::PopulateRayDirections(lidarTemplate);
+        EXPECT_EQ(directions.size(), ROS2::LidarTemplateUtils::TotalPointCount(lidarTemplate));
+        for (const auto& direction : directions)
+        {
+            EXPECT_NEAR(direction.GetLength(), 1.0f, 1e-5f);
+        }
+    }
+
+    TEST_F(LidarTest, RotatedRayDirections)
+    {
+        ROS2::LidarTemplate lidarTemplate;
+        lidarTemplate.m_minHAngle = 0.0f;
+        lidarTemplate.m_maxHAngle = 360.0f;
+        lidarTemplate.m_minVAngle = 0.0f;
+        lidarTemplate.m_maxVAngle = 0.0f;
+        lidarTemplate.m_layers = 1;
+        lidarTemplate.m_numberOfIncrements = 4;
+        const auto localDirections = ROS2::LidarTemplateUtils::PopulateRayDirections(lidarTemplate);
+        ASSERT_EQ(localDirections.size(), 4);
+
+        // Roll by 90 degrees moves the horizontal plane of the lidar into the XZ plane
+        const AZ::Quaternion roll = AZ::Quaternion::CreateRotationX(AZ::DegToRad(90.0f));
+        AZStd::vector<AZ::Vector3> directions;
+        ROS2::LidarTemplateUtils::RotateRayDirections(localDirections, roll, directions);
+        ASSERT_EQ(directions.size(), localDirections.size());
+
+        const AZStd::vector<AZ::Vector3> expected = {
+            { 1.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { -1.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, -1.0f }
+        };
+        for (size_t i = 0; i < expected.size(); i++)
+        {
+            EXPECT_TRUE(directions[i].IsClose(expected[i], 1e-5f));
+        }
+    }
+
+    TEST_F(LidarTest, RaycasterRequestPoolIsReused)
+    {
+        const auto lidarTemplate = ROS2::LidarTemplateUtils::GetTemplate(ROS2::LidarTemplate::Generic3DLidar);
+        const auto directions = ROS2::LidarTemplateUtils::PopulateRayDirections(lidarTemplate);
+
+        ROS2::LidarRaycaster raycaster;
+        raycaster.SetRayDirections(directions);
+        const size_t allocationCount = raycaster.GetAllocationCount();
+        EXPECT_GE(allocationCount, directions.size());
+
+        // Reconfiguring with the same number of rays must only update requests in place
+        raycaster.SetRayDirections(directions);
+        raycaster.SetRange(lidarTemplate.m_maxRange);
+        raycaster.SetIgnoredLayer(true, 1);
+        EXPECT_EQ(raycaster.GetAllocationCount(), allocationCount);
+    }
+
+    TEST_F(LidarTest, RaycasterScanReusesBuffers)
+    {
+        const auto lidarTemplate = ROS2::LidarTemplateUtils::GetTemplate(ROS2::LidarTemplate::Generic3DLidar);
+        const auto directions = ROS2::LidarTemplateUtils::PopulateRayDirections(lidarTemplate);
+        const size_t rayCount = directions.size();
+
+        ROS2::LidarRaycaster raycaster;
+        raycaster.SetRaycasterScene(AzPhysics::SceneHandle{ AZ::Crc32("LidarTestScene"), 0 });
+        raycaster.SetRayDirections(directions);
+        raycaster.SetRange(lidarTemplate.m_maxRange);
+        ROS2::LidarPointCloud pointCloud;
+        pointCloud.Configure(rayCount);
+
+        // Results of the physics scene are made up, the scene query itself is not a part of the raycaster
+        AzPhysics::SceneQueryHitsList results(rayCount);
+        size_t hitCount = 0;
+        for (size_t i = 0; i < rayCount; i += 2)
+        {
+            AzPhysics::SceneQueryHit hit;
+            hit.m_distance = 1.0f;
+            hit.m_normal = AZ::Vector3::CreateAxisZ();
+            results[i].m_hits.push_back(hit);
+            hitCount++;
+        }
+
+        const size_t allocationCount = raycaster.GetAllocationCount();
+        const auto* pointBuffer = pointCloud.GetMessage().data.data();
+        const void* partialRequests = nullptr;
+        for (int scan = 0; scan < 3; scan++)
+        { // Whole scans, then scans in two slices which use the partial request list
+            pointCloud.BeginScan();
+            const size_t sliceCount = scan == 0 ? 1 : 2;
+            size_t pointCount = 0;
+            for (size_t slice = 0; slice < sliceCount; slice++)
+            {
+                const size_t rayBegin = rayCount * slice / sliceCount;
+                const size_t rayEnd = rayCount * (slice + 1) / sliceCount;
+                ASSERT_TRUE(raycaster.PrepareRaycast(AZ::Transform::CreateIdentity(), rayBegin, rayEnd));
+                EXPECT_EQ(raycaster.GetPreparedRequests().size(), rayEnd - rayBegin);
+                if (slice == 1)
+                {
+                    partialRequests = partialRequests ? partialRequests : raycaster.GetPreparedRequests().data();
+                    EXPECT_EQ(raycaster.GetPreparedRequests().data(), partialRequests);
+                }
+                raycaster.CompleteRaycast(results, rayBegin);
+                pointCount += raycaster.WriteResults(pointCloud);
+            }
+            pointCloud.EndScan();
+            EXPECT_EQ(pointCount, hitCount);
+            EXPECT_EQ(pointCloud.GetPointCount(), hitCount);
+        }
+
+        // Buffers of the raycaster and the point cloud are kept between scans
+        EXPECT_EQ(raycaster.GetAllocationCount(), allocationCount);
+        EXPECT_EQ(pointCloud.GetMessage().data.data(), pointBuffer);
+    }
+
+    TEST_F(LidarTest, PointCloudLayout)
+    {
+        ROS2::LidarPointCloud pointCloud;
+        pointCloud.Configure(10);
+        const auto& message = pointCloud.GetMessage();
+        EXPECT_EQ(message.point_step, 12);
+        ASSERT_EQ(message.fields.size(), 3);
+        EXPECT_EQ(message.fields[0].offset, 0);
+        EXPECT_EQ(message.fields[1].offset, 4);
+        EXPECT_EQ(message.fields[2].offset, 8);
+
+        pointCloud.BeginScan();
+        ROS2::LidarPointXYZ* points = pointCloud.GetNextPoints<ROS2::LidarPointXYZ>();
+        const auto* bufferStart = message.data.data();
+        points[0] = { 1.0f, 2.0f, 3.0f };
+        pointCloud.AddPoints(1);
+        pointCloud.EndScan();
+        EXPECT_EQ(message.width, 1);
+        EXPECT_EQ(message.row_step, 12);
+        EXPECT_EQ(message.data.size(), 12);
+        EXPECT_TRUE(pointCloud.GetPointPosition(0).IsClose(AZ::Vector3(1.0f, 2.0f, 3.0f)));
+
+        // Consecutive scans reuse the same buffer
+        pointCloud.BeginScan();
+        pointCloud.AddPoints(10);
+        pointCloud.EndScan();
+        EXPECT_EQ(message.data.data(), bufferStart);
+        EXPECT_EQ(message.data.size(), 120);
+    }
+
+    TEST_F(LidarTest, PointCloudAccumulatesParts)
+    {
+        ROS2::LidarPointCloud pointCloud;
+        pointCloud.Configure(4);
+        pointCloud.BeginScan();
+        for (float slice = 0.0f; slice < 2.0f; slice += 1.0f)
+        { // Two parts of a scan, such as azimuth slices, each with two points
+            ROS2::LidarPointXYZ* points = pointCloud.GetNextPoints<ROS2::LidarPointXYZ>();
+            points[0] = { slice, 0.0f, 0.0f };
+            points[1] = { slice, 1.0f, 0.0f };
+            pointCloud.AddPoints(2);
+        }
+        pointCloud.EndScan();
+
+        EXPECT_EQ(pointCloud.GetPointCount(), 4);
+        EXPECT_TRUE(pointCloud.GetPointPosition(1).IsClose(AZ::Vector3(0.0f, 1.0f, 0.0f)));
+        EXPECT_TRUE(pointCloud.GetPointPosition(2).IsClose(AZ::Vector3(1.0f, 0.0f, 0.0f)));
+    }
+
+    TEST_F(LidarTest, PointCloudFormatWithRingAndTime)
+    {
+        ROS2::LidarPointCloud pointCloud;
+        pointCloud.Configure(1, ROS2::LidarTemplate::PointXYZIRT);
+        const auto& message = pointCloud.GetMessage();
+        EXPECT_EQ(message.point_step, sizeof(ROS2::LidarPointXYZIRT));
+        ASSERT_EQ(message.fields.size(), 6);
+        EXPECT_EQ(message.fields[4].name, "ring");
+        EXPECT_EQ(message.fields[4].datatype, sensor_msgs::msg::PointField::UINT16);
+        EXPECT_EQ(message.fields[5].name, "time");
+
+        pointCloud.BeginScan();
+        auto* points = pointCloud.GetNextPoints<ROS2::LidarPointXYZIRT>();
+        ROS2::LidarHit hit{ AZ::Vector3(1.0f, 2.0f, 3.0f), 3.74f, 0.5f, 7, 0.05f };
+        ROS2::FillPoint(points[0], hit);
+        pointCloud.AddPoints(1);
+        pointCloud.EndScan();
+        EXPECT_TRUE(pointCloud.GetPointPosition(0).IsClose(AZ::Vector3(1.0f, 2.0f, 3.0f)));
+        EXPECT_EQ(points[0].m_ring, 7);
+    }
+
+    TEST_F(LidarTest, RayRingsAndTimeOffsets)
+    {
+        const auto lidarTemplate = ROS2::LidarTemplateUtils::GetTemplate(ROS2::LidarTemplate::Generic3DLidar);
+        const float scanDuration = 0.1f;
+        const auto rings = ROS2::LidarTemplateUtils::PopulateRayRings(lidarTemplate);
+        const auto timeOffsets = ROS2::LidarTemplateUtils::PopulateRayTimeOffsets(lidarTemplate, scanDuration);
+        ASSERT_EQ(rings.size(), ROS2::LidarTemplateUtils::TotalPointCount(lidarTemplate));
+        ASSERT_EQ(timeOffsets.size(), rings.size());
+        EXPECT_EQ(rings.front(), 0);
+        EXPECT_EQ(rings.back(), lidarTemplate.m_layers - 1);
+        EXPECT_FLOAT_EQ(timeOffsets.front(), 0.0f);
+        EXPECT_LT(timeOffsets.back(), scanDuration);
+    }
+
+    TEST_F(LidarTest, BeamTableDirections)
+    {
+        ROS2::LidarTemplate lidarTemplate;
+        lidarTemplate.m_name = "TwoBeams";
+        lidarTemplate.m_layers = 2;
+        lidarTemplate.m_numberOfIncrements = 1;
+        lidarTemplate.m_maxRange = 10.0f;
+        lidarTemplate.m_beamElevations = { -30.0f, 30.0f };
+        lidarTemplate.m_beamAzimuthOffsets = { 0.0f, 90.0f };
+        EXPECT_TRUE(ROS2::LidarTemplateUtils::ValidateTemplate(lidarTemplate).IsSuccess());
+
+        const auto directions = ROS2::LidarTemplateUtils::PopulateRayDirections(lidarTemplate);
+        ASSERT_EQ(directions.size(), 2);
+        const float cos30 = AZ::Cos(AZ::DegToRad(30.0f));
+        EXPECT_TRUE(directions[0].IsClose(AZ::Vector3(cos30, 0.0f, -0.5f)));
+        EXPECT_TRUE(directions[1].IsClose(AZ::Vector3(0.0f, cos30, 0.5f)));
+
+        lidarTemplate.m_beamAzimuthOffsets = { 0.0f };
+        EXPECT_FALSE(ROS2::LidarTemplateUtils::ValidateTemplate(lidarTemplate).IsSuccess());
+    }
+
+    TEST_F(LidarTest, NoiseIsReproducible)
+    {
+        ROS2::LidarNoiseParameters parameters;
+        parameters.m_rangeStdDev = 0.1f;
+        parameters.m_dropoutProbabilityAtMaxRange = 0.5f;
+        parameters.m_seed = 42;
+
+        constexpr size_t rayCount = 10000;
+        constexpr float range = 50.0f;
+        constexpr float maxRange = 100.0f;
+        ROS2::LidarNoise noise;
+        ROS2::LidarNoise otherNoise;
+        constexpr AZ::u64 sensorKey = 7;
+        noise.SetParameters(parameters, sensorKey);
+        otherNoise.SetParameters(parameters, sensorKey);
+        noise.BeginScan(1);
+        otherNoise.BeginScan(1);
+
+        size_t droppedCount = 0;
+        double sum = 0.0;
+        double squaredSum = 0.0;
+        for (size_t i = 0; i < rayCount; i++)
+        {
+            float noisyRange = range;
+            float otherNoisyRange = range;
+            const auto result = noise.ApplyToHit(i, noisyRange, maxRange);
+            EXPECT_EQ(result, otherNoise.ApplyToHit(i, otherNoisyRange, maxRange));
+            EXPECT_EQ(noisyRange, otherNoisyRange);
+            if (result == ROS2::LidarNoise::HitResult::Dropped)
+            {
+                droppedCount++;
+                continue;
+            }
+            sum += noisyRange - range;
+            squaredSum += (noisyRange - range) * (noisyRange - range);
+        }
+
+        // Dropout probability at half of max range is 0.25
+        EXPECT_NEAR(static_cast<double>(droppedCount) / rayCount, 0.25, 0.02);
+        const size_t keptCount = rayCount - droppedCount;
+        EXPECT_NEAR(sum / keptCount, 0.0, 0.01);
+        EXPECT_NEAR(AZStd::sqrt(squaredSum / keptCount), 0.1, 0.01);
+
+        // Next scan has different noise
+        float firstRange = range;
+        float nextScanRange = range;
+        otherNoise.ApplyToHit(1, firstRange, maxRange);
+        otherNoise.BeginScan(2);
+        otherNoise.ApplyToHit(1, nextScanRange, maxRange);
+        EXPECT_NE(firstRange, nextScanRange);
+
+        // Noise of a scan depends on its index only, not on scans before it
+        float repeatedRange = range;
+        noise.BeginScan(2);
+        noise.ApplyToHit(1, repeatedRange, maxRange);
+        EXPECT_EQ(repeatedRange, nextScanRange);
+
+        // Another sensor with the same seed has different noise
+        ROS2::LidarNoise otherSensorNoise;
+        otherSensorNoise.SetParameters(parameters, sensorKey + 1);
+        otherSensorNoise.BeginScan(2);
+        float otherSensorRange = range;
+        otherSensorNoise.ApplyToHit(1, otherSensorRange, maxRange);
+        EXPECT_NE(otherSensorRange, nextScanRange);
+    }
+
+    TEST_F(LidarTest, StaticSceneIntersections)
+    {
+        // Floor at z = 0 on layer 0 and wall at x = 5 on layer 1
+        const AZStd::vector<AZ::Vector3> vertices = {
+            AZ::Vector3(-10.0f, -10.0f, 0.0f), AZ::Vector3(10.0f, -10.0f, 0.0f), AZ::Vector3(10.0f, 10.0f, 0.0f),
+            AZ::Vector3(-10.0f, 10.0f, 0.0f),  AZ::Vector3(5.0f, -10.0f, 0.0f),  AZ::Vector3(5.0f, 10.0f, 0.0f),
+            AZ::Vector3(5.0f, 10.0f, 10.0f),   AZ::Vector3(5.0f, -10.0f, 10.0f),
+        };
+        const AZStd::vector<AZ::u32> indices = { 0, 1, 2, 0, 2, 3, 4, 5, 6, 4, 6, 7 };
+        const AZStd::vector<AZ::u8> layers = { 0, 0, 1, 1 };
+        ROS2::LidarStaticScene scene;
+        scene.Build(vertices, indices, layers);
+        EXPECT_EQ(scene.GetTriangleCount(), 4);
+
+        const AZ::Vector3 origin(0.0f, 0.0f, 1.0f);
+        const AZStd::vector<AZ::Vector3> directions = {
+            AZ::Vector3(0.0f, 0.0f, -1.0f), // Floor
+            AZ::Vector3(1.0f, 0.0f, 0.0f), // Wall
+            AZ::Vector3(0.0f, 0.0f, 1.0f), // Nothing above
+            AZ::Vector3(-1.0f, 0.0f, 0.0f), // Nothing behind
+        };
+        constexpr float maxRange = 100.0f;
+        AZStd::vector<float> distances(directions.size(), maxRange);
+        AZStd::vector<AZ::Vector3> normals(directions.size(), AZ::Vector3::CreateZero());
+        scene.IntersectRays(origin, directions.data(), directions.size(), false, 0, distances.data(), normals.data());
+        EXPECT_NEAR(distances[0], 1.0f, 1e-4f);
+        EXPECT_NEAR(AZ::GetAbs(normals[0].GetZ()), 1.0f, 1e-4f);
+        EXPECT_NEAR(distances[1], 5.0f, 1e-4f);
+        EXPECT_NEAR(AZ::GetAbs(normals[1].GetX()), 1.0f, 1e-4f);
+        EXPECT_EQ(distances[2], maxRange);
+        EXPECT_EQ(distances[3], maxRange);
+
+        // Rays pass through the wall when its layer is ignored
+        AZStd::fill(distances.begin(), distances.end(), maxRange);
+        scene.IntersectRays(origin, directions.data(), directions.size(), true, 1, distances.data(), normals.data());
+        EXPECT_NEAR(distances[0], 1.0f, 1e-4f);
+        EXPECT_EQ(distances[1], maxRange);
+    }
+
+    TEST_F(LidarTest, PointFilterCropsAndDownsamples)
+    {
+        constexpr size_t pointCount = 6;
+        ROS2::LidarPointCloud pointCloud;
+        pointCloud.Configure(pointCount, ROS2::LidarTemplate::PointXYZIRT);
+        ROS2::LidarPointFilterParameters parameters;
+        parameters.m_minRange = 0.5f;
+        parameters.m_maxRange = 10.0f;
+        parameters.m_voxelSize = 1.0f;
+        ROS2::LidarPointFilter filter;
+        filter.Configure(parameters, pointCount);
+
+        // Filtering the same scan twice checks that the voxel table is emptied between scans
+        for (int scan = 0; scan < 2; scan++)
+        {
+            pointCloud.BeginScan();
+            auto* points = pointCloud.GetNextPoints<ROS2::LidarPointXYZIRT>();
+            points[0] = { 0.1f, 0.0f, 0.0f, 1.0f, 0, 0.0f }; // Too close
+            points[1] = { 2.2f, 0.0f, 0.0f, 1.0f, 1, 0.0f };
+            points[2] = { 2.6f, 0.0f, 0.0f, 1.0f, 2, 0.0f }; // Same voxel as the previous one
+            points[3] = { 20.0f, 0.0f, 0.0f, 1.0f, 3, 0.0f }; // Too far
+            points[4] = { -3.5f, 0.0f, 0.0f, 1.0f, 4, 0.0f };
+            points[5] = { 2.4f, 0.6f, 0.0f, 1.0f, 5, 0.0f }; // Same voxel as the second one
+            pointCloud.AddPoints(pointCount);
+            pointCloud.EndScan();
+
+            EXPECT_EQ(filter.Apply(pointCloud), 2);
+            EXPECT_EQ(pointCloud.GetPointCount(), 2);
+            const auto* filteredPoints = pointCloud.GetPoints<ROS2::LidarPointXYZIRT>();
+            EXPECT_NEAR(filteredPoints[0].m_x, 2.4f, 1e-5f);
+            EXPECT_NEAR(filteredPoints[0].m_y, 0.2f, 1e-5f);
+            EXPECT_EQ(filteredPoints[0].m_ring, 1);
+            EXPECT_EQ(filteredPoints[1].m_ring, 4);
+        }
+
+        EXPECT_EQ(filter.GetStatistics().m_lastInputPointCount, pointCount);
+        EXPECT_EQ(filter.GetStatistics().m_lastOutputPointCount, 2);
+        EXPECT_EQ(filter.GetStatistics().m_totalInputPointCount, 2 * pointCount);
+        EXPECT_EQ(filter.GetStatistics().m_totalOutputPointCount, 4);
+    }
+
+    TEST_F(LidarTest, PointFilterDecimatesRays)
+    {
+        ROS2::LidarTemplate lidarTemplate = ROS2::LidarTemplateUtils::GetTemplate(ROS2::LidarTemplate::Generic3DLidar);
+        lidarTemplate.m_layers = 3;
+        lidarTemplate.m_numberOfIncrements = 4;
+        auto directions = ROS2::LidarTemplateUtils::PopulateRayDirections(lidarTemplate);
+        auto rings = ROS2::LidarTemplateUtils::PopulateRayRings(lidarTemplate);
+        auto timeOffsets = ROS2::LidarTemplateUtils::PopulateRayTimeOffsets(lidarTemplate, 0.4f);
+        const auto allDirections = directions;
+
+        ROS2::LidarPointFilterParameters parameters;
+        parameters.m_ringStep = 2;
+        parameters.m_columnStep = 3;
+        const unsigned int columnCount = ROS2::LidarPointFilter::DecimateRays(parameters, 3, directions, rings, timeOffsets);
+
+        // Rings 0 and 2 of columns 0 and 3 are kept
+        EXPECT_EQ(columnCount, 2);
+        ASSERT_EQ(directions.size(), 4);
+        ASSERT_EQ(rings.size(), 4);
+        ASSERT_EQ(timeOffsets.size(), 4);
+        const size_t keptRays[] = { 0, 2, 9, 11 };
+        for (size_t i = 0; i < directions.size(); i++)
+        {
+            EXPECT_TRUE(directions[i].IsClose(allDirections[keptRays[i]]));
+            EXPECT_EQ(rings[i], keptRays[i] % 3);
+            EXPECT_NEAR(timeOffsets[i], (keptRays[i] / 3) * 0.1f, 1e-5f);
+        }
+    }
+} // namespace UnitTest
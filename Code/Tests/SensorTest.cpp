@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) Contributors to the Open 3D Engine Project.
+ * For complete copyright and license terms please see the LICENSE at the root of this distribution.
+ *
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ */
+
+#include <AzCore/UnitTest/TestTypes.h>
+#include <AzTest/AzTest.h>
+
+#include "Sensor/SensorSchedule.h"
+
+namespace UnitTest
+{
+
+    class SensorTest : public AllocatorsTestFixture
+    {
+    };
+
+    TEST_F(SensorTest, SensorScheduleSamplesAboveFrameRate)
+    {
+        ROS2::SensorSchedule schedule;
+        int sampleCount = 0;
+        double sampledTime = 0.0;
+        schedule.AddSensor(
+            200.0f,
+            [&sampleCount, &sampledTime, &schedule](double sampleTime, double sampleInterval)
+            {
+                EXPECT_EQ(sampleTime, schedule.GetTime()); // Sampled at the end of the step
+                sampleCount++;
+                sampledTime += sampleInterval;
+            });
+
+        for (int step = 0; step < 1000; step++)
+        { // One second of 1 ms physics substeps
+            schedule.Advance(0.001);
+        }
+
+        EXPECT_EQ(sampleCount, 200);
+        EXPECT_NEAR(sampledTime, 1.0, 1e-9);
+        EXPECT_EQ(schedule.GetSkippedSampleCount(), 0);
+    }
+
+    TEST_F(SensorTest, SensorScheduleLimitsRateToStepRate)
+    {
+        ROS2::SensorSchedule schedule;
+        int sampleCount = 0;
+        schedule.AddSensor(
+            1000.0f,
+            [&sampleCount](double, double sampleInterval)
+            {
+                EXPECT_NEAR(sampleInterval, 0.01, 1e-9);
+                sampleCount++;
+            });
+
+        for (int step = 0; step < 100; step++)
+        {
+            schedule.Advance(0.01);
+        }
+
+        EXPECT_EQ(sampleCount, 100); // Once per step
+        EXPECT_GT(schedule.GetSkippedSampleCount(), 0);
+    }
+
+    TEST_F(SensorTest, SensorScheduleStaggersSensorsOfSameRate)
+    {
+        constexpr int sensorCount = 4;
+        ROS2::SensorSchedule schedule;
+        std::vector<int> sampleCountByStep;
+        int sampleCount = 0;
+        for (int i = 0; i < sensorCount; i++)
+        {
+            schedule.AddSensor(
+                10.0f,
+                [&sampleCount](double, double)
+                {
+                    sampleCount++;
+                });
+        }
+
+        for (int step = 0; step < 100; step++)
+        { // One second of 10 ms steps, the period is 10 steps
+            sampleCount = 0;
+            schedule.Advance(0.01);
+            sampleCountByStep.push_back(sampleCount);
+        }
+
+        int totalSampleCount = 0;
+        for (int count : sampleCountByStep)
+        {
+            EXPECT_LE(count, 1); // Sensors spread over the period instead of being due in the same step
+            totalSampleCount += count;
+        }
+        EXPECT_EQ(totalSampleCount, sensorCount * 10);
+    }
+
+    TEST_F(SensorTest, SensorScheduleRemovedSensorIsNotSampled)
+    {
+        ROS2::SensorSchedule schedule;
+        int sampleCount = 0;
+        auto sensorId = schedule.AddSensor(
+            100.0f,
+            [&sampleCount](double, double)
+            {
+                sampleCount++;
+            });
+
+        schedule.Advance(0.05);
+        EXPECT_EQ(sampleCount, 1);
+        schedule.RemoveSensor(sensorId);
+        schedule.Advance(0.05);
+        EXPECT_EQ(sampleCount, 1);
+        EXPECT_TRUE(schedule.IsEmpty());
+    }
+
+    TEST_F(SensorTest, SensorScheduleSamplesStepSensorsOnEveryStep)
+    {
+        ROS2::SensorSchedule schedule;
+        int sampleCount = 0;
+        auto sensorId = schedule.AddStepSensor(
+            [&sampleCount, &schedule](double sampleTime, double sampleInterval)
+            {
+                EXPECT_EQ(sampleTime, schedule.GetTime());
+                EXPECT_NEAR(sampleInterval, 0.005, 1e-9);
+                sampleCount++;
+            });
+
+        for (int step = 0; step < 10; step++)
+        {
+            schedule.Advance(0.005);
+        }
+        EXPECT_EQ(sampleCount, 10);
+        EXPECT_EQ(schedule.GetSkippedSampleCount(), 0);
+
+        schedule.RemoveSensor(sensorId);
+        schedule.Advance(0.005);
+        EXPECT_EQ(sampleCount, 10);
+        EXPECT_TRUE(schedule.IsEmpty());
+    }
+
+} // namespace UnitTest
@@ -9,31 +9,53 @@ set(FILES
         ../Assets/Passes/PipelineROSColor.pass
         ../Assets/Passes/PipelineROSDepth.pass
         ../Assets/Passes/ROSPassTemplates.azasset
+        Source/Camera/CameraImageEncoder.cpp
+        Source/Camera/CameraImageEncoder.h
+        Source/Camera/CameraPipeline.cpp
+        Source/Camera/CameraPipeline.h
+        Source/Camera/CameraPointCloud.cpp
+        Source/Camera/CameraPointCloud.h
         Source/Camera/CameraSensor.cpp
         Source/Camera/CameraSensor.h
         Source/Camera/ROS2CameraSensorComponent.cpp
         Source/Camera/ROS2CameraSensorComponent.h
         Source/Clock/SimulationClock.cpp
         Source/Clock/SimulationClock.h
+        Source/Communication/MainThreadCallbackQueue.cpp
+        Source/Communication/MainThreadCallbackQueue.h
         Source/Communication/QoS.cpp
         Source/Communication/TopicConfiguration.cpp
         Source/Frame/NamespaceConfiguration.cpp
         Source/Frame/ROS2FrameComponent.cpp
         Source/Frame/ROS2Transform.cpp
+        Source/Frame/TransformAggregator.cpp
+        Source/Frame/TransformAggregator.h
         Source/GNSS/GNSSFormatConversions.cpp
         Source/GNSS/GNSSFormatConversions.h
         Source/GNSS/ROS2GNSSSensorComponent.cpp
         Source/GNSS/ROS2GNSSSensorComponent.h
         Source/Imu/ROS2ImuSensorComponent.cpp
         Source/Imu/ROS2ImuSensorComponent.h
+        Source/Lidar/LidarNoise.cpp
+        Source/Lidar/LidarNoise.h
+        Source/Lidar/LidarPointCloud.cpp
+        Source/Lidar/LidarPointCloud.h
+        Source/Lidar/LidarPointFilter.cpp
+        Source/Lidar/LidarPointFilter.h
+        Source/Lidar/LidarPointTypes.h
         Source/Lidar/LidarRaycaster.cpp
         Source/Lidar/LidarRaycaster.h
+        Source/Lidar/LidarStaticScene.cpp
+        Source/Lidar/LidarStaticScene.h
+        Source/Lidar/LidarSystemBus.h
         Source/Lidar/LidarTemplate.cpp
         Source/Lidar/LidarTemplate.h
         Source/Lidar/LidarTemplateUtils.cpp
         Source/Lidar/LidarTemplateUtils.h
         Source/Lidar/ROS2LidarSensorComponent.cpp
         Source/Lidar/ROS2LidarSensorComponent.h
+        Source/Lidar/ROS2LidarSystemComponent.cpp
+        Source/Lidar/ROS2LidarSystemComponent.h
         Source/Manipulator/MotorizedJointComponent.cpp
         Source/Odometry/ROS2OdometrySensorComponent.cpp
         Source/Odometry/ROS2OdometrySensorComponent.h
@@ -54,6 +76,10 @@ set(FILES
         Source/ROS2SystemComponent.h
         Source/Sensor/ROS2SensorComponent.cpp
         Source/Sensor/SensorConfiguration.cpp
+        Source/Sensor/SensorSchedule.cpp
+        Source/Sensor/SensorSchedule.h
+        Source/Sensor/SensorScheduler.cpp
+        Source/Sensor/SensorScheduler.h
         Source/Spawner/ROS2SpawnerComponent.cpp
         Source/Spawner/ROS2SpawnerComponent.h
         Source/Spawner/ROS2SpawnPointComponent.cpp
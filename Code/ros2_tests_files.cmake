@@ -5,5 +5,9 @@
 
 set(FILES
     Tests/ROS2Test.cpp
+    Tests/CameraTest.cpp
+    Tests/CommunicationTest.cpp
     Tests/GNSSTest.cpp
+    Tests/LidarTest.cpp
+    Tests/SensorTest.cpp
 )